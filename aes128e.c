@@ -4,6 +4,17 @@
 // DATE: 20-oct-2014
 // MODIFIED: 27-oct-2014 //addition of encryption context structure
 //           29-oct-2014 //ROTWORD to avoid multiple swap definitions
+//           17-oct-2026 //key context, round keys expanded only once
+//           17-oct-2026 //selectable block cipher backends
+//           17-oct-2026 //AES-NI backend, counter mode entry point
+//           17-oct-2026 //bitsliced backend as the portable default
+//           17-oct-2026 //multi key block encryption
+//           17-oct-2026 //AVX-512 VAES backend
+//           17-oct-2026 //instrumentation hooks
+//           17-oct-2026 //bulk key expansion
+//           17-oct-2026 //constant time SubWord in the key schedule
+//           17-oct-2026 //multi key bitsliced blocks
+//           17-oct-2026 //bitsliced round keys derived per call
 // DESCRIPTION:
 //  This file is the implementation of the AES128 encryption standard
 //-------------------------------------------------------------------
@@ -11,8 +22,12 @@
 #include <stdio.h> //standard header
 #include <stdint.h>
 #include <stdlib.h> // memory allocation
+#include <string.h>
 
 #include "aes128e.h" //local includes
+#include "aes128e_impl.h"
+#include "cpu_features.h"
+#include "aes128gcm_stats.h"
 
 /* Multiplication by two in GF(2^8). Multiplication by three is xtime(a) ^ a */
 #define xtime(a) ( ((a) & 0x80) ? (((a) << 1) ^ 0x1b) : ((a) << 1) )
@@ -20,6 +35,9 @@
 #define ROWS 4
 #define COLS 4
 #define ROUNDS 10
+//counter blocks handed to aes128e_blocks() at once by the generic
+//counter mode
+#define CTR_BATCH 32
 //performs the rotation of word n-times
 #define ROTWORD(A, n) \
         for(int i=0;i<n;i++)\
@@ -76,33 +94,306 @@ store it at c. */
 void aes128e(unsigned char *c, const unsigned char *p, 
               const unsigned char *k) 
 {
-  enc_ctxt *ctxt= malloc(sizeof(enc_ctxt));
-  init_mat(p, k, ctxt);  
+  key_ctxt kctxt;
 
-  //round zero
-  addroundkey(ctxt);
-  keysched(0, ctxt);
-  //round 1 to 9
-  for(int i=1; i<ROUNDS; i++)
-  {
-    subbytes(ctxt);
-    shiftrows(ctxt);
-    mixcolumns(ctxt);
-    addroundkey(ctxt);
-    keysched(i, ctxt);
-  }
-  //final round
-  subbytes(ctxt);
-  shiftrows(ctxt);
-  addroundkey(ctxt);
+  aes128e_set_key(&kctxt, k);
+  aes128e_blocks(&kctxt, c, p, 1);
+  aes128e_clear_key(&kctxt);
+}//end of aes128e
 
-  //copy cipher text
+//-------------------------------------------------------------------
+//copies the round key in FIPS-197 byte order to the key matrix
+static void load_roundkey(enc_ctxt *ctxt, const unsigned char *rk)
+{
   for(int i=0; i<ROWS; i++)
     for(int j=0; j<COLS; j++)
-      c[(i*ROWS)+j]=ctxt->state[j][i];
+      ctxt->key[i][j]=rk[(COLS*j)+i];
+}
 
-  free(ctxt);
-}//end of aes128e
+//-------------------------------------------------------------------
+void aes128e_set_key(key_ctxt *kctxt, const unsigned char *k)
+{
+  int backend=aes128e_default_backend();
+
+  if(backend==AES128E_AESNI || backend==AES128E_VAES)
+    aes128e_set_key_aesni(kctxt, k);
+  else
+    aes128e_expand_words(kctxt, k);
+  aes128e_set_backend(kctxt, backend);
+}
+
+//-------------------------------------------------------------------
+void aes128e_set_keys(key_ctxt *const *kctxts,
+                      const unsigned char *const *keys, unsigned int n)
+{
+  int backend=aes128e_default_backend();
+
+  if(backend==AES128E_VAES)
+    aes128e_set_keys_vaes(kctxts, keys, n);
+  else if(backend==AES128E_AESNI)
+    aes128e_set_keys_aesni(kctxts, keys, n);
+  else
+    for(unsigned int i=0; i<n; i++)
+      aes128e_expand_words(kctxts[i], keys[i]);
+  for(unsigned int i=0; i<n; i++)
+    aes128e_set_backend(kctxts[i], backend);
+}
+
+//-------------------------------------------------------------------
+void aes128e_expand_ref(key_ctxt *kctxt, const unsigned char *k)
+{
+  enc_ctxt ctxt;
+
+  init_mat(k, k, &ctxt);
+  for(int r=0; r<=ROUNDS; r++)
+  {
+    for(int i=0; i<ROWS; i++)
+      for(int j=0; j<COLS; j++)
+        kctxt->rk[r][(COLS*j)+i]=ctxt.key[i][j];
+    if(r<ROUNDS)
+      keysched(r, &ctxt);
+  }
+  aes128e_wipe(&ctxt, sizeof(ctxt));
+}
+
+//-------------------------------------------------------------------
+void aes128e_expand_words(key_ctxt *kctxt, const unsigned char *k)
+{
+  uint32_t w[4], t;
+
+  for(int i=0; i<4; i++)
+    w[i]= ((uint32_t)k[4*i] << 24) | ((uint32_t)k[4*i+1] << 16) |
+          ((uint32_t)k[4*i+2] << 8) | (uint32_t)k[4*i+3];
+  memcpy(kctxt->rk[0], k, 16);
+  for(int r=1; r<=ROUNDS; r++)
+  {
+    //SubWord(RotWord(w3))^rcon, the sbox table is not indexed with
+    //key bytes
+    t=aes128e_bitslice_subword((w[3] << 8) | (w[3] >> 24));
+    w[0]^= t ^ ((uint32_t)rcon[r-1] << 24);
+    w[1]^=w[0];
+    w[2]^=w[1];
+    w[3]^=w[2];
+    for(int i=0; i<4; i++)
+    {
+      kctxt->rk[r][4*i]=(unsigned char)(w[i] >> 24);
+      kctxt->rk[r][4*i+1]=(unsigned char)(w[i] >> 16);
+      kctxt->rk[r][4*i+2]=(unsigned char)(w[i] >> 8);
+      kctxt->rk[r][4*i+3]=(unsigned char)w[i];
+    }
+  }
+  aes128e_wipe(w, sizeof(w));
+}
+
+//-------------------------------------------------------------------
+int aes128e_set_backend(key_ctxt *kctxt, int backend)
+{
+  switch(backend)
+  {
+    case AES128E_REF:
+    case AES128E_TTABLE:
+      kctxt->backend=backend;
+      GCM_STAT_AES(backend);
+      return 0;
+    case AES128E_AESNI:
+      if((cpu_features() & (CPU_AESNI|CPU_SSE41)) != (CPU_AESNI|CPU_SSE41))
+        return -1;
+      kctxt->backend=backend;
+      GCM_STAT_AES(backend);
+      return 0;
+    case AES128E_BITSLICE:
+      kctxt->backend=backend;
+      GCM_STAT_AES(backend);
+      return 0;
+    case AES128E_VAES:
+      if((cpu_features() & (CPU_AESNI|CPU_SSE41|CPU_VAES512)) !=
+         (CPU_AESNI|CPU_SSE41|CPU_VAES512))
+        return -1;
+      kctxt->backend=backend;
+      GCM_STAT_AES(backend);
+      return 0;
+    default:
+      return -1;
+  }
+}
+
+//-------------------------------------------------------------------
+int aes128e_default_backend(void)
+{
+  if((cpu_features() & (CPU_AESNI|CPU_SSE41|CPU_VAES512)) ==
+     (CPU_AESNI|CPU_SSE41|CPU_VAES512))
+    return AES128E_VAES;
+  if((cpu_features() & (CPU_AESNI|CPU_SSE41)) == (CPU_AESNI|CPU_SSE41))
+    return AES128E_AESNI;
+  //constant time is preferred over the faster T-table rounds
+  return AES128E_BITSLICE;
+}
+
+//-------------------------------------------------------------------
+void aes128e_blocks(const key_ctxt *kctxt, unsigned char *c,
+                    const unsigned char *p, unsigned long nblocks)
+{
+  switch(kctxt->backend)
+  {
+    case AES128E_TTABLE:
+      aes128e_blocks_ttable(kctxt, c, p, nblocks);
+      break;
+    case AES128E_AESNI:
+      aes128e_blocks_aesni(kctxt, c, p, nblocks);
+      break;
+    case AES128E_BITSLICE:
+      aes128e_blocks_bitslice(kctxt, c, p, nblocks);
+      break;
+    case AES128E_VAES:
+      aes128e_blocks_vaes(kctxt, c, p, nblocks);
+      break;
+    default:
+      aes128e_blocks_ref(kctxt, c, p, nblocks);
+      break;
+  }
+}
+
+//-------------------------------------------------------------------
+void aes128e_blocks_multi(const key_ctxt *const *kctxts, unsigned char *c,
+                          const unsigned char *p, unsigned long nblocks)
+{
+  int aesni=1, bitslice=1;
+
+  //VAES keys share the AES-NI round keys
+  for(unsigned long i=0; i<nblocks; i++)
+  {
+    aesni&= kctxts[i]->backend==AES128E_AESNI ||
+            kctxts[i]->backend==AES128E_VAES;
+    bitslice&= kctxts[i]->backend==AES128E_BITSLICE;
+  }
+  if(aesni)
+    aes128e_blocks_multi_aesni(kctxts, c, p, nblocks);
+  else if(bitslice)
+    aes128e_blocks_multi_bitslice(kctxts, c, p, nblocks);
+  else
+    for(unsigned long i=0; i<nblocks; i++)
+      aes128e_blocks(kctxts[i], &c[16*i], &p[16*i], 1);
+}
+
+//-------------------------------------------------------------------
+void aes128e_ctr32(const key_ctxt *kctxt, unsigned char *out,
+                   const unsigned char *in, unsigned char *ctr,
+                   unsigned long nblocks)
+{
+  GCM_STAT_BEGIN(t);
+
+  switch(kctxt->backend)
+  {
+    case AES128E_AESNI:
+      aes128e_ctr32_aesni(kctxt, out, in, ctr, nblocks);
+      break;
+    case AES128E_BITSLICE:
+      aes128e_ctr32_bitslice(kctxt, out, in, ctr, nblocks);
+      break;
+    case AES128E_VAES:
+      aes128e_ctr32_vaes(kctxt, out, in, ctr, nblocks);
+      break;
+    default:
+      aes128e_ctr32_generic(kctxt, out, in, ctr, nblocks);
+      break;
+  }
+  GCM_STAT_END(t, GCM_STAGE_CTR, 16*nblocks);
+}
+
+//-------------------------------------------------------------------
+//increments the last 32 bits of the counter block, big endian
+static void inc32(unsigned char *ctr)
+{
+  for(int i=15; i>=12; i--)
+    if(++ctr[i])
+      break;
+}
+
+//-------------------------------------------------------------------
+void aes128e_ctr32_generic(const key_ctxt *kctxt, unsigned char *out,
+                           const unsigned char *in, unsigned char *ctr,
+                           unsigned long nblocks)
+{
+  unsigned char ctr_blk[16*CTR_BATCH];
+  unsigned char ks[16*CTR_BATCH];
+
+  while(nblocks)
+  {
+    unsigned long n= (nblocks < CTR_BATCH) ? nblocks : CTR_BATCH;
+    for(unsigned long j=0; j<n; j++)
+    {
+      for(int i=0; i<16; i++)
+        ctr_blk[16*j+i]=ctr[i];
+      inc32(ctr);
+    }
+    aes128e_blocks(kctxt, ks, ctr_blk, n);
+    for(unsigned long i=0; i<16*n; i++)
+      out[i]=in[i]^ks[i];
+    in+=16*n;
+    out+=16*n;
+    nblocks-=n;
+  }
+  aes128e_wipe(ks, sizeof(ks));
+}
+
+//-------------------------------------------------------------------
+void aes128e_blocks_ref(const key_ctxt *kctxt, unsigned char *c,
+                        const unsigned char *p, unsigned long nblocks)
+{
+  enc_ctxt ctxt;
+
+  for(unsigned long b=0; b<nblocks; b++, c+=16, p+=16)
+  {
+    for(int i=0; i<ROWS; i++)
+      for(int j=0; j<COLS; j++)
+        ctxt.state[i][j]=p[(COLS*j)+i];
+
+    //round zero
+    load_roundkey(&ctxt, kctxt->rk[0]);
+    addroundkey(&ctxt);
+    //round 1 to 9
+    for(int r=1; r<ROUNDS; r++)
+    {
+      subbytes(&ctxt);
+      shiftrows(&ctxt);
+      mixcolumns(&ctxt);
+      load_roundkey(&ctxt, kctxt->rk[r]);
+      addroundkey(&ctxt);
+    }
+    //final round
+    subbytes(&ctxt);
+    shiftrows(&ctxt);
+    load_roundkey(&ctxt, kctxt->rk[ROUNDS]);
+    addroundkey(&ctxt);
+
+    //copy cipher text
+    for(int i=0; i<ROWS; i++)
+      for(int j=0; j<COLS; j++)
+        c[(i*ROWS)+j]=ctxt.state[j][i];
+  }
+  aes128e_wipe(&ctxt, sizeof(ctxt));
+}
+
+//-------------------------------------------------------------------
+void aes128e_clear_key(key_ctxt *kctxt)
+{
+  aes128e_wipe(kctxt, sizeof(*kctxt));
+}
+
+//-------------------------------------------------------------------
+void aes128e_wipe(void *buf, size_t len)
+{
+#if defined(__GNUC__)
+  //the empty asm claims to read buf, so the memset cannot be dropped
+  memset(buf, 0, len);
+  __asm__ __volatile__("" : : "r"(buf) : "memory");
+#else
+  //volatile pointer so the wipe is not optimised away
+  volatile unsigned char *v=(volatile unsigned char *)buf;
+  for(size_t i=0; i<len; i++)
+    v[i]=0x00;
+#endif
+}
 
 //-------------------------------------------------------------------
 void print_mat(unsigned char mat[][4])
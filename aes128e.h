@@ -7,9 +7,20 @@
 // DATE: 20-oct-2014
 // MODIFIED: 27-oct-2014 //added encryption context structure
 //           27-oct-2014 //added comments
+//           17-oct-2026 //added expanded key context
+//           17-oct-2026 //added backend selection
+//           17-oct-2026 //added AES-NI backend and aes128e_ctr32
+//           17-oct-2026 //added bitsliced backend
+//           17-oct-2026 //added aes128e_blocks_multi
+//           17-oct-2026 //added VAES backend
+//           17-oct-2026 //added aes128e_set_keys
+//           17-oct-2026 //key context holds the round keys only
 // DESCRIPTION:
 //-------------------------------------------------------------------
 
+#include <stddef.h>
+#include <stdint.h>
+
 //definition of Encryption context structure
 typedef struct 
 {
@@ -17,6 +28,25 @@ typedef struct
   unsigned char key[4][4];//holds key matrix
 }enc_ctxt;
 
+#define AES128_ROUNDS 10
+
+//block cipher backends, all give identical output
+enum
+{
+  AES128E_REF=0, //byte-wise reference pipeline
+  AES128E_TTABLE, //32-bit combined table rounds
+  AES128E_AESNI, //AES-NI instructions, needs CPU support
+  AES128E_BITSLICE, //constant time bitsliced, 8 blocks per pass
+  AES128E_VAES //AVX-512 VAES, 16 blocks per loop, needs CPU support
+};
+
+//definition of expanded key context structure
+typedef struct
+{
+  unsigned char rk[AES128_ROUNDS+1][16];//round keys, FIPS-197 byte order
+  int backend;//block cipher backend used by aes128e_blocks
+}key_ctxt;
+
 
 void aes128e(unsigned char *c, const unsigned char *p, 
               const unsigned char *k);
@@ -30,6 +60,109 @@ void aes128e(unsigned char *c, const unsigned char *p,
 //  k(IN)- pointer to key
 //-------------------------------------------------------------------
 
+void aes128e_set_key(key_ctxt *kctxt, const unsigned char *k);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  expands the 16-byte key at k into all 11 round keys. the context
+//  can be reused for any number of aes128e_blocks() calls. the
+//  backend is set to aes128e_default_backend()
+// PARAMETERS:
+//  kctxt(OUT)- pointer to key context
+//  k(IN)- pointer to key
+//-------------------------------------------------------------------
+
+void aes128e_set_keys(key_ctxt *const *kctxts,
+                      const unsigned char *const *keys, unsigned int n);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  aes128e_set_key() of n keys at once, the expansions of several
+//  keys are interleaved (8 with AES-NI, 16 with VAES)
+// PARAMETERS:
+//  kctxts(OUT)- one key context per key
+//  keys(IN)- pointers to the 16-byte keys
+//  n(IN)- number of keys
+//-------------------------------------------------------------------
+
+void aes128e_blocks(const key_ctxt *kctxt, unsigned char *c,
+                    const unsigned char *p, unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  encrypts nblocks consecutive 16-byte blocks at p under the
+//  expanded key and stores them at c. c and p may be the same buffer
+// PARAMETERS:
+//  kctxt(IN)- pointer to key context
+//  c(OUT)- pointer to cipher text
+//  p(IN)- pointer to plain text
+//  nblocks(IN)- number of blocks
+//-------------------------------------------------------------------
+
+int aes128e_set_backend(key_ctxt *kctxt, int backend);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  selects the block cipher backend used with this key context
+// PARAMETERS:
+//  kctxt(IN/OUT)- pointer to key context
+//  backend(IN)- one of AES128E_*
+// RETURN:
+//  0 on success, -1 if the backend is not available on this host
+//-------------------------------------------------------------------
+
+int aes128e_default_backend(void);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  returns the fastest backend available on this host
+//-------------------------------------------------------------------
+
+void aes128e_blocks_multi(const key_ctxt *const *kctxts, unsigned char *c,
+                          const unsigned char *p, unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  encrypts block i of p under kctxts[i]. used to interleave the
+//  blocks of many independent short messages, with AES-NI 8 blocks
+//  of different keys are kept in flight and bitsliced keys share
+//  one pass per 8 blocks
+// PARAMETERS:
+//  kctxts(IN)- one key context per block
+//  c(OUT)- pointer to cipher text
+//  p(IN)- pointer to plain text
+//  nblocks(IN)- number of blocks
+//-------------------------------------------------------------------
+
+void aes128e_ctr32(const key_ctxt *kctxt, unsigned char *out,
+                   const unsigned char *in, unsigned char *ctr,
+                   unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  counter mode over nblocks blocks. ctr is the first counter block,
+//  its last 32 bits are incremented (big endian, modulo 2^32) for
+//  every block as GCM requires. each encrypted counter is XORed onto
+//  in and stored at out. in and out may be the same buffer
+// PARAMETERS:
+//  kctxt(IN)- pointer to key context
+//  out(OUT)- pointer to output
+//  in(IN)- pointer to input
+//  ctr(IN/OUT)- counter block, on return the next unused counter
+//  nblocks(IN)- number of blocks
+//-------------------------------------------------------------------
+
+void aes128e_clear_key(key_ctxt *kctxt);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  wipes the round keys held in the key context
+// PARAMETERS:
+//  kctxt(IN/OUT)- pointer to key context
+//-------------------------------------------------------------------
+
+void aes128e_wipe(void *buf, size_t len);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  zeroes len bytes at buf in a way the compiler cannot drop. used
+//  for key material and keystream that must not outlive its use
+// PARAMETERS:
+//  buf(OUT)- pointer to memory to be wiped
+//  len(IN)- number of bytes
+//-------------------------------------------------------------------
+
 void print_mat(unsigned char mat[][4]);
 //-------------------------------------------------------------------
 // DESCRIPTION:
@@ -0,0 +1,258 @@
+//-------------------------------------------------------------------
+// FILE: aes128e_aesni.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  AES-NI implementation of the AES128 key expansion and rounds.
+//  must be compiled with -maes -msse4.1, it is only called when
+//  cpu_features() reports CPU_AESNI
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+
+#include "aes128e.h"
+#include "aes128e_impl.h"
+
+#if defined(__AES__) && defined(__SSE4_1__)
+
+#include <wmmintrin.h>
+#include <smmintrin.h>
+
+//number of independent blocks kept in flight, enough to cover the
+//latency of aesenc on current cores
+#define LANES 8
+
+//-------------------------------------------------------------------
+//one step of the key expansion, kg holds aeskeygenassist(key, rcon)
+static inline __m128i expand_step(__m128i key, __m128i kg)
+{
+  kg= _mm_shuffle_epi32(kg, 0xff);
+  key= _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key= _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key= _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, kg);
+}
+
+//rcon has to be an immediate for aeskeygenassist
+#define EXPAND(k, rcon) expand_step((k), _mm_aeskeygenassist_si128((k), (rcon)))
+
+//-------------------------------------------------------------------
+void aes128e_set_key_aesni(key_ctxt *kctxt, const unsigned char *k)
+{
+  __m128i *rk=(__m128i *)kctxt->rk;
+  __m128i t=_mm_loadu_si128((const __m128i *)k);
+
+  _mm_storeu_si128(rk+0, t);
+  t=EXPAND(t, 0x01); _mm_storeu_si128(rk+1, t);
+  t=EXPAND(t, 0x02); _mm_storeu_si128(rk+2, t);
+  t=EXPAND(t, 0x04); _mm_storeu_si128(rk+3, t);
+  t=EXPAND(t, 0x08); _mm_storeu_si128(rk+4, t);
+  t=EXPAND(t, 0x10); _mm_storeu_si128(rk+5, t);
+  t=EXPAND(t, 0x20); _mm_storeu_si128(rk+6, t);
+  t=EXPAND(t, 0x40); _mm_storeu_si128(rk+7, t);
+  t=EXPAND(t, 0x80); _mm_storeu_si128(rk+8, t);
+  t=EXPAND(t, 0x1b); _mm_storeu_si128(rk+9, t);
+  t=EXPAND(t, 0x36); _mm_storeu_si128(rk+10, t);
+}
+
+//-------------------------------------------------------------------
+//one step of the key expansion without aeskeygenassist: with the
+//rotated last word in every column ShiftRows is a no-op and
+//aesenclast leaves SubWord(RotWord(w3))^rcon in every word
+static inline __m128i expand_step_enclast(__m128i key, __m128i rcon)
+{
+  const __m128i rot=_mm_set1_epi32(0x0c0f0e0d);
+  __m128i t=_mm_aesenclast_si128(_mm_shuffle_epi8(key, rot), rcon);
+
+  key= _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key= _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key= _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, t);
+}
+
+//-------------------------------------------------------------------
+void aes128e_set_keys_aesni(key_ctxt *const *kctxts,
+                            const unsigned char *const *keys,
+                            unsigned int n)
+{
+  static const int rcon[AES128_ROUNDS]={0x01, 0x02, 0x04, 0x08, 0x10,
+                                        0x20, 0x40, 0x80, 0x1b, 0x36};
+
+  //the expansions of LANES keys advance side by side
+  for(unsigned int i=0; i<n; i+=LANES)
+  {
+    unsigned int m= (n-i < LANES) ? n-i : LANES;
+    __m128i t[LANES];
+
+    for(unsigned int j=0; j<m; j++)
+    {
+      t[j]=_mm_loadu_si128((const __m128i *)keys[i+j]);
+      _mm_storeu_si128((__m128i *)kctxts[i+j]->rk[0], t[j]);
+    }
+    for(int r=1; r<=AES128_ROUNDS; r++)
+    {
+      __m128i rc=_mm_set1_epi32(rcon[r-1]);
+
+      for(unsigned int j=0; j<m; j++)
+      {
+        t[j]=expand_step_enclast(t[j], rc);
+        _mm_storeu_si128((__m128i *)kctxts[i+j]->rk[r], t[j]);
+      }
+    }
+  }
+}
+
+//-------------------------------------------------------------------
+static inline void load_keys(const key_ctxt *kctxt, __m128i *rk)
+{
+  for(int r=0; r<=AES128_ROUNDS; r++)
+    rk[r]=_mm_loadu_si128((const __m128i *)kctxt->rk[r]);
+}
+
+//-------------------------------------------------------------------
+//encrypts LANES independent blocks with the rounds interleaved
+static inline void encrypt_lanes(const __m128i *rk, __m128i *b)
+{
+  for(int j=0; j<LANES; j++)
+    b[j]=_mm_xor_si128(b[j], rk[0]);
+  for(int r=1; r<AES128_ROUNDS; r++)
+    for(int j=0; j<LANES; j++)
+      b[j]=_mm_aesenc_si128(b[j], rk[r]);
+  for(int j=0; j<LANES; j++)
+    b[j]=_mm_aesenclast_si128(b[j], rk[AES128_ROUNDS]);
+}
+
+//-------------------------------------------------------------------
+static inline __m128i encrypt_one(const __m128i *rk, __m128i b)
+{
+  b=_mm_xor_si128(b, rk[0]);
+  for(int r=1; r<AES128_ROUNDS; r++)
+    b=_mm_aesenc_si128(b, rk[r]);
+  return _mm_aesenclast_si128(b, rk[AES128_ROUNDS]);
+}
+
+//-------------------------------------------------------------------
+void aes128e_blocks_aesni(const key_ctxt *kctxt, unsigned char *c,
+                          const unsigned char *p, unsigned long nblocks)
+{
+  __m128i rk[AES128_ROUNDS+1];
+  __m128i b[LANES];
+
+  load_keys(kctxt, rk);
+  for(; nblocks>=LANES; nblocks-=LANES, p+=16*LANES, c+=16*LANES)
+  {
+    for(int j=0; j<LANES; j++)
+      b[j]=_mm_loadu_si128((const __m128i *)(p+16*j));
+    encrypt_lanes(rk, b);
+    for(int j=0; j<LANES; j++)
+      _mm_storeu_si128((__m128i *)(c+16*j), b[j]);
+  }
+  for(; nblocks; nblocks--, p+=16, c+=16)
+    _mm_storeu_si128((__m128i *)c,
+                     encrypt_one(rk, _mm_loadu_si128((const __m128i *)p)));
+}
+
+//-------------------------------------------------------------------
+void aes128e_ctr32_aesni(const key_ctxt *kctxt, unsigned char *out,
+                         const unsigned char *in, unsigned char *ctr,
+                         unsigned long nblocks)
+{
+  __m128i rk[AES128_ROUNDS+1];
+  __m128i b[LANES];
+  __m128i base=_mm_loadu_si128((const __m128i *)ctr);
+  uint32_t n= ((uint32_t)ctr[12] << 24) | ((uint32_t)ctr[13] << 16) |
+              ((uint32_t)ctr[14] << 8) | (uint32_t)ctr[15];
+
+  load_keys(kctxt, rk);
+  //counter blocks are built in registers, only the last word changes
+  for(; nblocks>=LANES; nblocks-=LANES, in+=16*LANES, out+=16*LANES)
+  {
+    for(int j=0; j<LANES; j++)
+      b[j]=_mm_insert_epi32(base, (int)__builtin_bswap32(n+j), 3);
+    n+=LANES;
+    encrypt_lanes(rk, b);
+    for(int j=0; j<LANES; j++)
+      _mm_storeu_si128((__m128i *)(out+16*j),
+                       _mm_xor_si128(b[j],
+                         _mm_loadu_si128((const __m128i *)(in+16*j))));
+  }
+  for(; nblocks; nblocks--, in+=16, out+=16, n++)
+  {
+    __m128i e=encrypt_one(rk, _mm_insert_epi32(base,
+                                (int)__builtin_bswap32(n), 3));
+    _mm_storeu_si128((__m128i *)out,
+                     _mm_xor_si128(e, _mm_loadu_si128((const __m128i *)in)));
+  }
+
+  ctr[12]=(unsigned char)(n >> 24);
+  ctr[13]=(unsigned char)(n >> 16);
+  ctr[14]=(unsigned char)(n >> 8);
+  ctr[15]=(unsigned char)n;
+}
+
+//-------------------------------------------------------------------
+void aes128e_blocks_multi_aesni(const key_ctxt *const *kctxts,
+                                unsigned char *c, const unsigned char *p,
+                                unsigned long nblocks)
+{
+  __m128i b[LANES];
+
+  //every lane reads its round keys from its own context
+  for(; nblocks>=LANES; nblocks-=LANES, p+=16*LANES, c+=16*LANES,
+                        kctxts+=LANES)
+  {
+    for(int j=0; j<LANES; j++)
+      b[j]=_mm_xor_si128(_mm_loadu_si128((const __m128i *)(p+16*j)),
+             _mm_loadu_si128((const __m128i *)kctxts[j]->rk[0]));
+    for(int r=1; r<AES128_ROUNDS; r++)
+      for(int j=0; j<LANES; j++)
+        b[j]=_mm_aesenc_si128(b[j],
+               _mm_loadu_si128((const __m128i *)kctxts[j]->rk[r]));
+    for(int j=0; j<LANES; j++)
+      _mm_storeu_si128((__m128i *)(c+16*j), _mm_aesenclast_si128(b[j],
+        _mm_loadu_si128((const __m128i *)kctxts[j]->rk[AES128_ROUNDS])));
+  }
+  for(; nblocks; nblocks--, p+=16, c+=16, kctxts++)
+    aes128e_blocks_aesni(*kctxts, c, p, 1);
+}
+
+#else
+
+//built without AES-NI support, cpu_features() never selects these
+void aes128e_set_key_aesni(key_ctxt *kctxt, const unsigned char *k)
+{
+  aes128e_expand_ref(kctxt, k);
+}
+
+void aes128e_set_keys_aesni(key_ctxt *const *kctxts,
+                            const unsigned char *const *keys,
+                            unsigned int n)
+{
+  for(unsigned int i=0; i<n; i++)
+    aes128e_expand_ref(kctxts[i], keys[i]);
+}
+
+void aes128e_blocks_aesni(const key_ctxt *kctxt, unsigned char *c,
+                          const unsigned char *p, unsigned long nblocks)
+{
+  aes128e_blocks_ttable(kctxt, c, p, nblocks);
+}
+
+void aes128e_ctr32_aesni(const key_ctxt *kctxt, unsigned char *out,
+                         const unsigned char *in, unsigned char *ctr,
+                         unsigned long nblocks)
+{
+  aes128e_ctr32_generic(kctxt, out, in, ctr, nblocks);
+}
+
+void aes128e_blocks_multi_aesni(const key_ctxt *const *kctxts,
+                                unsigned char *c, const unsigned char *p,
+                                unsigned long nblocks)
+{
+  for(; nblocks; nblocks--, p+=16, c+=16, kctxts++)
+    aes128e_blocks_ttable(*kctxts, c, p, 1);
+}
+
+#endif
+
+//end of file
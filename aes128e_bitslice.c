@@ -0,0 +1,592 @@
+//-------------------------------------------------------------------
+// FILE: aes128e_bitslice.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  constant time bitsliced implementation of the AES128 rounds. no
+//  table is indexed with secret data. the state of 4 blocks is held
+//  in 8 words of 64 bits (one word per bit of every byte); with GCC
+//  vector extensions two such groups share 128-bit registers so 8
+//  blocks are encrypted per pass. the sbox is the Boyar-Peralta
+//  circuit (https://eprint.iacr.org/2009/191.pdf), the data layout
+//  follows the ct64 code of BearSSL
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+#include <string.h>
+
+#include "aes128e.h"
+#include "aes128e_impl.h"
+
+#if defined(__GNUC__)
+//two 64-bit slices per register, 8 blocks per pass
+typedef uint64_t bs_word __attribute__((vector_size(16)));
+#define GROUPS 2
+#else
+typedef uint64_t bs_word;
+#define GROUPS 1
+#endif
+
+#define LANES (4*GROUPS)
+
+//-------------------------------------------------------------------
+static void bs_sbox(bs_word *q)
+{
+  bs_word x0, x1, x2, x3, x4, x5, x6, x7;
+  bs_word y1, y2, y3, y4, y5, y6, y7, y8, y9, y10, y11;
+  bs_word y12, y13, y14, y15, y16, y17, y18, y19, y20, y21;
+  bs_word z0, z1, z2, z3, z4, z5, z6, z7, z8, z9, z10, z11;
+  bs_word z12, z13, z14, z15, z16, z17;
+  bs_word t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11;
+  bs_word t12, t13, t14, t15, t16, t17, t18, t19, t20, t21;
+  bs_word t22, t23, t24, t25, t26, t27, t28, t29, t30, t31;
+  bs_word t32, t33, t34, t35, t36, t37, t38, t39, t40, t41;
+  bs_word t42, t43, t44, t45, t46, t47, t48, t49, t50, t51;
+  bs_word t52, t53, t54, t55, t56, t57, t58, t59, t60, t61;
+  bs_word t62, t63, t64, t65, t66, t67;
+  bs_word s0, s1, s2, s3, s4, s5, s6, s7;
+
+  //x0 is the most significant bit
+  x0=q[7]; x1=q[6]; x2=q[5]; x3=q[4];
+  x4=q[3]; x5=q[2]; x6=q[1]; x7=q[0];
+
+  //top linear transformation
+  y14=x3 ^ x5;
+  y13=x0 ^ x6;
+  y9=x0 ^ x3;
+  y8=x0 ^ x5;
+  t0=x1 ^ x2;
+  y1=t0 ^ x7;
+  y4=y1 ^ x3;
+  y12=y13 ^ y14;
+  y2=y1 ^ x0;
+  y5=y1 ^ x6;
+  y3=y5 ^ y8;
+  t1=x4 ^ y12;
+  y15=t1 ^ x5;
+  y20=t1 ^ x1;
+  y6=y15 ^ x7;
+  y10=y15 ^ t0;
+  y11=y20 ^ y9;
+  y7=x7 ^ y11;
+  y17=y10 ^ y11;
+  y19=y10 ^ y8;
+  y16=t0 ^ y11;
+  y21=y13 ^ y16;
+  y18=x0 ^ y16;
+
+  //non-linear section
+  t2=y12 & y15;
+  t3=y3 & y6;
+  t4=t3 ^ t2;
+  t5=y4 & x7;
+  t6=t5 ^ t2;
+  t7=y13 & y16;
+  t8=y5 & y1;
+  t9=t8 ^ t7;
+  t10=y2 & y7;
+  t11=t10 ^ t7;
+  t12=y9 & y11;
+  t13=y14 & y17;
+  t14=t13 ^ t12;
+  t15=y8 & y10;
+  t16=t15 ^ t12;
+  t17=t4 ^ t14;
+  t18=t6 ^ t16;
+  t19=t9 ^ t14;
+  t20=t11 ^ t16;
+  t21=t17 ^ y20;
+  t22=t18 ^ y19;
+  t23=t19 ^ y21;
+  t24=t20 ^ y18;
+
+  t25=t21 ^ t22;
+  t26=t21 & t23;
+  t27=t24 ^ t26;
+  t28=t25 & t27;
+  t29=t28 ^ t22;
+  t30=t23 ^ t24;
+  t31=t22 ^ t26;
+  t32=t31 & t30;
+  t33=t32 ^ t24;
+  t34=t23 ^ t33;
+  t35=t27 ^ t33;
+  t36=t24 & t35;
+  t37=t36 ^ t34;
+  t38=t27 ^ t36;
+  t39=t29 & t38;
+  t40=t25 ^ t39;
+
+  t41=t40 ^ t37;
+  t42=t29 ^ t33;
+  t43=t29 ^ t40;
+  t44=t33 ^ t37;
+  t45=t42 ^ t41;
+  z0=t44 & y15;
+  z1=t37 & y6;
+  z2=t33 & x7;
+  z3=t43 & y16;
+  z4=t40 & y1;
+  z5=t29 & y7;
+  z6=t42 & y11;
+  z7=t45 & y17;
+  z8=t41 & y10;
+  z9=t44 & y12;
+  z10=t37 & y3;
+  z11=t33 & y4;
+  z12=t43 & y13;
+  z13=t40 & y5;
+  z14=t29 & y2;
+  z15=t42 & y9;
+  z16=t45 & y14;
+  z17=t41 & y8;
+
+  //bottom linear transformation
+  t46=z15 ^ z16;
+  t47=z10 ^ z11;
+  t48=z5 ^ z13;
+  t49=z9 ^ z10;
+  t50=z2 ^ z12;
+  t51=z2 ^ z5;
+  t52=z7 ^ z8;
+  t53=z0 ^ z3;
+  t54=z6 ^ z7;
+  t55=z16 ^ z17;
+  t56=z12 ^ t48;
+  t57=t50 ^ t53;
+  t58=z4 ^ t46;
+  t59=z3 ^ t54;
+  t60=t46 ^ t57;
+  t61=z14 ^ t57;
+  t62=t52 ^ t58;
+  t63=t49 ^ t58;
+  t64=z4 ^ t59;
+  t65=t61 ^ t62;
+  t66=z1 ^ t63;
+  s0=t59 ^ t63;
+  s6=t56 ^ ~t62;
+  s7=t48 ^ ~t60;
+  t67=t64 ^ t65;
+  s3=t53 ^ t66;
+  s4=t51 ^ t66;
+  s5=t47 ^ t65;
+  s1=t64 ^ ~s3;
+  s2=t55 ^ ~t67;
+
+  q[7]=s0; q[6]=s1; q[5]=s2; q[4]=s3;
+  q[3]=s4; q[2]=s5; q[1]=s6; q[0]=s7;
+}
+
+//swaps the bits selected by cl in x with those by ch in y
+#define SWAPN(cl, ch, s, x, y) \
+        { uint64_t a_=(x), b_=(y); \
+          (x)= (a_ & (uint64_t)cl) | ((b_ & (uint64_t)cl) << (s)); \
+          (y)= ((a_ & (uint64_t)ch) >> (s)) | (b_ & (uint64_t)ch); }
+#define SWAP2(x, y) SWAPN(0x5555555555555555, 0xAAAAAAAAAAAAAAAA, 1, x, y)
+#define SWAP4(x, y) SWAPN(0x3333333333333333, 0xCCCCCCCCCCCCCCCC, 2, x, y)
+#define SWAP8(x, y) SWAPN(0x0F0F0F0F0F0F0F0F, 0xF0F0F0F0F0F0F0F0, 4, x, y)
+
+//-------------------------------------------------------------------
+//transposes between byte and bitsliced representation, it is its
+//own inverse
+static void bs_ortho(uint64_t *q)
+{
+  SWAP2(q[0], q[1]);
+  SWAP2(q[2], q[3]);
+  SWAP2(q[4], q[5]);
+  SWAP2(q[6], q[7]);
+
+  SWAP4(q[0], q[2]);
+  SWAP4(q[1], q[3]);
+  SWAP4(q[4], q[6]);
+  SWAP4(q[5], q[7]);
+
+  SWAP8(q[0], q[4]);
+  SWAP8(q[1], q[5]);
+  SWAP8(q[2], q[6]);
+  SWAP8(q[3], q[7]);
+}
+
+//-------------------------------------------------------------------
+//spreads the four little endian words of one block over two slices
+static void bs_interleave_in(uint64_t *q0, uint64_t *q1, const uint32_t *w)
+{
+  uint64_t x0=w[0], x1=w[1], x2=w[2], x3=w[3];
+
+  x0|=(x0 << 16); x1|=(x1 << 16); x2|=(x2 << 16); x3|=(x3 << 16);
+  x0&=(uint64_t)0x0000FFFF0000FFFF;
+  x1&=(uint64_t)0x0000FFFF0000FFFF;
+  x2&=(uint64_t)0x0000FFFF0000FFFF;
+  x3&=(uint64_t)0x0000FFFF0000FFFF;
+  x0|=(x0 << 8); x1|=(x1 << 8); x2|=(x2 << 8); x3|=(x3 << 8);
+  x0&=(uint64_t)0x00FF00FF00FF00FF;
+  x1&=(uint64_t)0x00FF00FF00FF00FF;
+  x2&=(uint64_t)0x00FF00FF00FF00FF;
+  x3&=(uint64_t)0x00FF00FF00FF00FF;
+  *q0=x0 | (x2 << 8);
+  *q1=x1 | (x3 << 8);
+}
+
+//-------------------------------------------------------------------
+static void bs_interleave_out(uint32_t *w, uint64_t q0, uint64_t q1)
+{
+  uint64_t x0, x1, x2, x3;
+
+  x0=q0 & (uint64_t)0x00FF00FF00FF00FF;
+  x1=q1 & (uint64_t)0x00FF00FF00FF00FF;
+  x2=(q0 >> 8) & (uint64_t)0x00FF00FF00FF00FF;
+  x3=(q1 >> 8) & (uint64_t)0x00FF00FF00FF00FF;
+  x0|=(x0 >> 8); x1|=(x1 >> 8); x2|=(x2 >> 8); x3|=(x3 >> 8);
+  x0&=(uint64_t)0x0000FFFF0000FFFF;
+  x1&=(uint64_t)0x0000FFFF0000FFFF;
+  x2&=(uint64_t)0x0000FFFF0000FFFF;
+  x3&=(uint64_t)0x0000FFFF0000FFFF;
+  w[0]=(uint32_t)x0 | (uint32_t)(x0 >> 16);
+  w[1]=(uint32_t)x1 | (uint32_t)(x1 >> 16);
+  w[2]=(uint32_t)x2 | (uint32_t)(x2 >> 16);
+  w[3]=(uint32_t)x3 | (uint32_t)(x3 >> 16);
+}
+
+//-------------------------------------------------------------------
+static void bs_shiftrows(bs_word *q)
+{
+  for(int i=0; i<8; i++)
+  {
+    bs_word x=q[i];
+    q[i]= (x & (uint64_t)0x000000000000FFFF)
+        | ((x & (uint64_t)0x00000000FFF00000) >> 4)
+        | ((x & (uint64_t)0x00000000000F0000) << 12)
+        | ((x & (uint64_t)0x0000FF0000000000) >> 8)
+        | ((x & (uint64_t)0x000000FF00000000) << 8)
+        | ((x & (uint64_t)0xF000000000000000) >> 12)
+        | ((x & (uint64_t)0x0FFF000000000000) << 4);
+  }
+}
+
+#define ROTR32(x) (((x) << 32) | ((x) >> 32))
+#define ROTR16(x) (((x) >> 16) | ((x) << 48))
+
+//-------------------------------------------------------------------
+static void bs_mixcolumns(bs_word *q)
+{
+  bs_word q0=q[0], q1=q[1], q2=q[2], q3=q[3];
+  bs_word q4=q[4], q5=q[5], q6=q[6], q7=q[7];
+  bs_word r0=ROTR16(q0), r1=ROTR16(q1), r2=ROTR16(q2), r3=ROTR16(q3);
+  bs_word r4=ROTR16(q4), r5=ROTR16(q5), r6=ROTR16(q6), r7=ROTR16(q7);
+
+  q[0]=q7 ^ r7 ^ r0 ^ ROTR32(q0 ^ r0);
+  q[1]=q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ ROTR32(q1 ^ r1);
+  q[2]=q1 ^ r1 ^ r2 ^ ROTR32(q2 ^ r2);
+  q[3]=q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ ROTR32(q3 ^ r3);
+  q[4]=q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ ROTR32(q4 ^ r4);
+  q[5]=q4 ^ r4 ^ r5 ^ ROTR32(q5 ^ r5);
+  q[6]=q5 ^ r5 ^ r6 ^ ROTR32(q6 ^ r6);
+  q[7]=q6 ^ r6 ^ r7 ^ ROTR32(q7 ^ r7);
+}
+
+//-------------------------------------------------------------------
+static void bs_addroundkey(bs_word *q, const uint64_t *sk)
+{
+  for(int i=0; i<8; i++)
+    q[i]^=sk[i];
+}
+
+//-------------------------------------------------------------------
+//bitsliced round keys of kctxt, derived per call so that key_ctxt
+//holds rk only. round keys r..r+3 are transposed together, one per
+//block position, then each is replicated into all four positions
+static void bs_key(uint64_t (*sk)[8], const key_ctxt *kctxt)
+{
+  const uint64_t m=0x1111111111111111ULL;
+  uint64_t q[8];
+  uint32_t w[4];
+
+  for(int r=0; r<=AES128_ROUNDS; r+=4)
+  {
+    for(int i=0; i<4; i++)
+    {
+      const unsigned char *k=
+        kctxt->rk[(r+i<=AES128_ROUNDS) ? r+i : AES128_ROUNDS];
+
+      for(int j=0; j<4; j++)
+        w[j]= (uint32_t)k[4*j] | ((uint32_t)k[4*j+1] << 8) |
+              ((uint32_t)k[4*j+2] << 16) | ((uint32_t)k[4*j+3] << 24);
+      bs_interleave_in(&q[i], &q[i+4], w);
+    }
+    bs_ortho(q);
+    for(int i=0; i<4 && r+i<=AES128_ROUNDS; i++)
+      for(int j=0; j<8; j++)
+      {
+        uint64_t x=(q[j] >> i) & m;
+
+        x|=x << 1;
+        sk[r+i][j]=x | (x << 2);
+      }
+  }
+  aes128e_wipe(q, sizeof(q));
+  aes128e_wipe(w, sizeof(w));
+}
+
+//-------------------------------------------------------------------
+uint32_t aes128e_bitslice_subword(uint32_t x)
+{
+  uint64_t s[8]={x, 0, 0, 0, 0, 0, 0, 0};
+  bs_word q[8];
+
+  //the four bytes of x sit in the first block, the sbox of the
+  //others is discarded
+  bs_ortho(s);
+  for(int i=0; i<8; i++)
+  {
+#if GROUPS == 2
+    q[i]=(bs_word){ s[i], 0 };
+#else
+    q[i]=s[i];
+#endif
+  }
+  bs_sbox(q);
+  for(int i=0; i<8; i++)
+  {
+#if GROUPS == 2
+    s[i]=q[i][0];
+#else
+    s[i]=q[i];
+#endif
+  }
+  bs_ortho(s);
+  x=(uint32_t)s[0];
+  aes128e_wipe(s, sizeof(s));
+  aes128e_wipe(q, sizeof(q));
+  return x;
+}
+
+//-------------------------------------------------------------------
+//loads LANES blocks at p into the bitsliced state q
+static void bs_load(bs_word *q, const unsigned char *p)
+{
+  uint64_t s[GROUPS][8];
+  uint32_t w[16];
+
+  for(int g=0; g<GROUPS; g++)
+  {
+    for(int i=0; i<16; i++)
+    {
+      const unsigned char *b=p+64*g+4*i;
+      w[i]=(uint32_t)b[0] | ((uint32_t)b[1] << 8) |
+           ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+    }
+    for(int i=0; i<4; i++)
+      bs_interleave_in(&s[g][i], &s[g][i+4], w+4*i);
+    bs_ortho(s[g]);
+  }
+  for(int i=0; i<8; i++)
+  {
+#if GROUPS == 2
+    q[i]=(bs_word){ s[0][i], s[1][i] };
+#else
+    q[i]=s[0][i];
+#endif
+  }
+  aes128e_wipe(s, sizeof(s));
+  aes128e_wipe(w, sizeof(w));
+}
+
+//-------------------------------------------------------------------
+//stores the bitsliced state q as LANES blocks at c
+static void bs_store(unsigned char *c, const bs_word *q)
+{
+  uint64_t s[GROUPS][8];
+  uint32_t w[16];
+
+  for(int i=0; i<8; i++)
+  {
+#if GROUPS == 2
+    s[0][i]=q[i][0];
+    s[1][i]=q[i][1];
+#else
+    s[0][i]=q[i];
+#endif
+  }
+  for(int g=0; g<GROUPS; g++)
+  {
+    bs_ortho(s[g]);
+    for(int i=0; i<4; i++)
+      bs_interleave_out(w+4*i, s[g][i], s[g][i+4]);
+    for(int i=0; i<16; i++)
+    {
+      unsigned char *b=c+64*g+4*i;
+      b[0]=(unsigned char)w[i];
+      b[1]=(unsigned char)(w[i] >> 8);
+      b[2]=(unsigned char)(w[i] >> 16);
+      b[3]=(unsigned char)(w[i] >> 24);
+    }
+  }
+  aes128e_wipe(s, sizeof(s));
+  aes128e_wipe(w, sizeof(w));
+}
+
+//-------------------------------------------------------------------
+//encrypts LANES blocks at p to c under the round keys sk of bs_key()
+static void bs_encrypt(const uint64_t (*sk)[8], unsigned char *c,
+                       const unsigned char *p)
+{
+  bs_word q[8];
+
+  bs_load(q, p);
+  bs_addroundkey(q, sk[0]);
+  for(int r=1; r<AES128_ROUNDS; r++)
+  {
+    bs_sbox(q);
+    bs_shiftrows(q);
+    bs_mixcolumns(q);
+    bs_addroundkey(q, sk[r]);
+  }
+  bs_sbox(q);
+  bs_shiftrows(q);
+  bs_addroundkey(q, sk[AES128_ROUNDS]);
+  bs_store(c, q);
+}
+
+//-------------------------------------------------------------------
+//encrypts LANES blocks at p to c, block i under kctxts[i]. the round
+//keys of the pass are the round keys of the blocks loaded like data
+static void bs_encrypt_multi(const key_ctxt *const *kctxts,
+                             unsigned char *c, const unsigned char *p)
+{
+  unsigned char k[16*LANES];
+  bs_word q[8], sk[8];
+
+  bs_load(q, p);
+  for(int r=0; r<=AES128_ROUNDS; r++)
+  {
+    for(int i=0; i<LANES; i++)
+      memcpy(&k[16*i], kctxts[i]->rk[r], 16);
+    bs_load(sk, k);
+    if(r)
+    {
+      bs_sbox(q);
+      bs_shiftrows(q);
+      if(r<AES128_ROUNDS)
+        bs_mixcolumns(q);
+    }
+    for(int i=0; i<8; i++)
+      q[i]^=sk[i];
+  }
+  aes128e_wipe(k, sizeof(k));
+  aes128e_wipe(sk, sizeof(sk));
+  bs_store(c, q);
+}
+
+//-------------------------------------------------------------------
+void aes128e_blocks_multi_bitslice(const key_ctxt *const *kctxts,
+                                   unsigned char *c, const unsigned char *p,
+                                   unsigned long nblocks)
+{
+  uint64_t sk[AES128_ROUNDS+1][8];
+  const key_ctxt *keys[LANES], *cached=NULL;
+  unsigned char buf[16*LANES];
+
+  for(unsigned long i=0; i<nblocks; i+=LANES)
+  {
+    unsigned long n= (nblocks-i < LANES) ? nblocks-i : LANES;
+    const unsigned char *in=&p[16*i];
+    unsigned char *out=&c[16*i];
+    int same=1;
+
+    //a short tail runs its unused lanes under the first key
+    for(unsigned long j=0; j<LANES; j++)
+    {
+      keys[j]=kctxts[i+((j<n) ? j : 0)];
+      same&= keys[j]==keys[0];
+    }
+    if(n<LANES)
+    {
+      for(unsigned long j=0; j<16*LANES; j++)
+        buf[j]= (j<16*n) ? in[j] : 0x00;
+      in=out=buf;
+    }
+    //passes under one key share its schedule, derived once per run
+    if(same)
+    {
+      if(keys[0]!=cached)
+      {
+        bs_key(sk, keys[0]);
+        cached=keys[0];
+      }
+      bs_encrypt(sk, out, in);
+    }
+    else
+      bs_encrypt_multi(keys, out, in);
+    if(n<LANES)
+      for(unsigned long j=0; j<16*n; j++)
+        c[16*i+j]=buf[j];
+  }
+  aes128e_wipe(sk, sizeof(sk));
+  aes128e_wipe(buf, sizeof(buf));
+}
+
+//-------------------------------------------------------------------
+void aes128e_blocks_bitslice(const key_ctxt *kctxt, unsigned char *c,
+                             const unsigned char *p, unsigned long nblocks)
+{
+  uint64_t sk[AES128_ROUNDS+1][8];
+  unsigned char buf[16*LANES];
+
+  bs_key(sk, kctxt);
+  for(; nblocks>=LANES; nblocks-=LANES, p+=16*LANES, c+=16*LANES)
+    bs_encrypt(sk, c, p);
+  if(nblocks)
+  {
+    //short tail, pad the unused lanes
+    for(unsigned long i=0; i<16*LANES; i++)
+      buf[i]= (i<16*nblocks) ? p[i] : 0x00;
+    bs_encrypt(sk, buf, buf);
+    for(unsigned long i=0; i<16*nblocks; i++)
+      c[i]=buf[i];
+    aes128e_wipe(buf, sizeof(buf));
+  }
+  aes128e_wipe(sk, sizeof(sk));
+}
+
+//-------------------------------------------------------------------
+void aes128e_ctr32_bitslice(const key_ctxt *kctxt, unsigned char *out,
+                            const unsigned char *in, unsigned char *ctr,
+                            unsigned long nblocks)
+{
+  uint64_t sk[AES128_ROUNDS+1][8];
+  unsigned char ks[16*LANES];
+  uint32_t n= ((uint32_t)ctr[12] << 24) | ((uint32_t)ctr[13] << 16) |
+              ((uint32_t)ctr[14] << 8) | (uint32_t)ctr[15];
+
+  bs_key(sk, kctxt);
+  while(nblocks)
+  {
+    unsigned long m= (nblocks < LANES) ? nblocks : LANES;
+
+    for(int j=0; j<LANES; j++, n++)
+    {
+      for(int i=0; i<12; i++)
+        ks[16*j+i]=ctr[i];
+      ks[16*j+12]=(unsigned char)(n >> 24);
+      ks[16*j+13]=(unsigned char)(n >> 16);
+      ks[16*j+14]=(unsigned char)(n >> 8);
+      ks[16*j+15]=(unsigned char)n;
+    }
+    n-=LANES-m;
+    bs_encrypt(sk, ks, ks);
+    for(unsigned long i=0; i<16*m; i++)
+      out[i]=in[i]^ks[i];
+    in+=16*m;
+    out+=16*m;
+    nblocks-=m;
+  }
+  aes128e_wipe(ks, sizeof(ks));
+  aes128e_wipe(sk, sizeof(sk));
+
+  ctr[12]=(unsigned char)(n >> 24);
+  ctr[13]=(unsigned char)(n >> 16);
+  ctr[14]=(unsigned char)(n >> 8);
+  ctr[15]=(unsigned char)n;
+}
+
+//end of file
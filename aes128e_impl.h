@@ -0,0 +1,150 @@
+#ifndef AES128E_IMPL_H
+#define AES128E_IMPL_H
+
+//-------------------------------------------------------------------
+// FILE: aes128e_impl.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  internal header with the block cipher backends behind
+//  aes128e_blocks(). all of them take the same arguments and give
+//  identical output, they only differ in speed
+//-------------------------------------------------------------------
+
+#include "aes128e.h"
+
+void aes128e_expand_ref(key_ctxt *kctxt, const unsigned char *k);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  byte-wise key expansion with keysched(), fills kctxt->rk only
+//-------------------------------------------------------------------
+
+void aes128e_expand_words(key_ctxt *kctxt, const unsigned char *k);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  the same expansion on 32-bit words, without the state matrix. it
+//  is constant time, SubWord runs through the bitsliced sbox
+//-------------------------------------------------------------------
+
+void aes128e_ctr32_generic(const key_ctxt *kctxt, unsigned char *out,
+                           const unsigned char *in, unsigned char *ctr,
+                           unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  aes128e_ctr32() for backends without their own counter kernel.
+//  counter blocks are built in batches and run through
+//  aes128e_blocks()
+//-------------------------------------------------------------------
+
+void aes128e_blocks_ref(const key_ctxt *kctxt, unsigned char *c,
+                        const unsigned char *p, unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  byte-wise subbytes/shiftrows/mixcolumns pipeline on enc_ctxt
+//-------------------------------------------------------------------
+
+void aes128e_blocks_ttable(const key_ctxt *kctxt, unsigned char *c,
+                           const unsigned char *p, unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  32-bit combined table rounds, see aes128e_ttable.c
+//-------------------------------------------------------------------
+
+void aes128e_set_key_aesni(key_ctxt *kctxt, const unsigned char *k);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  AESKEYGENASSIST based key expansion, fills kctxt->rk only
+//-------------------------------------------------------------------
+
+void aes128e_set_keys_aesni(key_ctxt *const *kctxts,
+                            const unsigned char *const *keys,
+                            unsigned int n);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  expands n keys, 8 expansions interleaved with AESENCLAST doing
+//  the SubWord step, fills kctxts[i]->rk only
+//-------------------------------------------------------------------
+
+void aes128e_blocks_aesni(const key_ctxt *kctxt, unsigned char *c,
+                          const unsigned char *p, unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  AESENC/AESENCLAST rounds, 8 independent blocks in flight
+//-------------------------------------------------------------------
+
+void aes128e_ctr32_aesni(const key_ctxt *kctxt, unsigned char *out,
+                         const unsigned char *in, unsigned char *ctr,
+                         unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  counter mode with the counter blocks generated in registers,
+//  8 blocks in flight
+//-------------------------------------------------------------------
+
+void aes128e_blocks_multi_aesni(const key_ctxt *const *kctxts,
+                                unsigned char *c, const unsigned char *p,
+                                unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  block i under kctxts[i], 8 blocks of possibly different keys in
+//  flight
+//-------------------------------------------------------------------
+
+void aes128e_blocks_vaes(const key_ctxt *kctxt, unsigned char *c,
+                         const unsigned char *p, unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  VAES rounds on 512-bit registers, 4 blocks per instruction and
+//  16 blocks in flight. uses the AES-NI round keys
+//-------------------------------------------------------------------
+
+void aes128e_set_keys_vaes(key_ctxt *const *kctxts,
+                           const unsigned char *const *keys,
+                           unsigned int n);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  aes128e_set_keys_aesni() with 4 keys per 512-bit register and 16
+//  expansions in flight
+//-------------------------------------------------------------------
+
+void aes128e_ctr32_vaes(const key_ctxt *kctxt, unsigned char *out,
+                        const unsigned char *in, unsigned char *ctr,
+                        unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  counter mode with 16 counter blocks per loop built in 512-bit
+//  registers
+//-------------------------------------------------------------------
+
+uint32_t aes128e_bitslice_subword(uint32_t x);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  SubWord of the key schedule, the sbox applied to the four bytes
+//  of x by the bitsliced circuit, no table lookup
+//-------------------------------------------------------------------
+
+void aes128e_blocks_bitslice(const key_ctxt *kctxt, unsigned char *c,
+                             const unsigned char *p, unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  table free constant time rounds, 8 blocks per pass
+//-------------------------------------------------------------------
+
+void aes128e_blocks_multi_bitslice(const key_ctxt *const *kctxts,
+                                   unsigned char *c, const unsigned char *p,
+                                   unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  block i under kctxts[i], 8 blocks of possibly different keys per
+//  pass
+//-------------------------------------------------------------------
+
+void aes128e_ctr32_bitslice(const key_ctxt *kctxt, unsigned char *out,
+                            const unsigned char *in, unsigned char *ctr,
+                            unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  counter mode feeding 8 counter blocks per bitsliced pass
+//-------------------------------------------------------------------
+
+#endif
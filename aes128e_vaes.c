@@ -0,0 +1,183 @@
+//-------------------------------------------------------------------
+// FILE: aes128e_vaes.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  AVX-512 VAES implementation of the AES128 rounds, every
+//  VAESENC works on 4 blocks and 4 registers are kept in flight. the
+//  round keys are the AES-NI ones broadcast to all lanes. must be
+//  compiled with the VAES_FLAGS of the Makefile, it is only called
+//  when cpu_features() reports CPU_VAES512
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+
+#include "aes128e.h"
+#include "aes128e_impl.h"
+
+#if defined(__VAES__) && defined(__AVX512F__) && defined(__AVX512BW__)
+
+#include "aes128e_vaes_inline.h"
+
+//-------------------------------------------------------------------
+void aes128e_blocks_vaes(const key_ctxt *kctxt, unsigned char *c,
+                         const unsigned char *p, unsigned long nblocks)
+{
+  __m512i rk[AES128_ROUNDS+1];
+  __m512i b[VAES_REGS];
+  int nregs;
+
+  vaes_load_keys(kctxt, rk);
+  for(; nblocks>=VAES_BLOCKS; nblocks-=VAES_BLOCKS, p+=16*VAES_BLOCKS,
+                              c+=16*VAES_BLOCKS)
+  {
+    for(int j=0; j<VAES_REGS; j++)
+      b[j]=_mm512_loadu_si512(p+64*j);
+    vaes_encrypt(rk, b, VAES_REGS);
+    for(int j=0; j<VAES_REGS; j++)
+      _mm512_storeu_si512(c+64*j, b[j]);
+  }
+
+  //tail of up to 15 blocks with masked loads and stores
+  nregs=(int)((nblocks+VAES_LANES-1)/VAES_LANES);
+  for(int j=0; j<nregs; j++)
+    b[j]=_mm512_maskz_loadu_epi8(vaes_mask(nblocks-VAES_LANES*j), p+64*j);
+  vaes_encrypt(rk, b, nregs);
+  for(int j=0; j<nregs; j++)
+    _mm512_mask_storeu_epi8(c+64*j, vaes_mask(nblocks-VAES_LANES*j), b[j]);
+}
+
+//-------------------------------------------------------------------
+//keys k[0..3] in the 4 lanes
+static inline __m512i load_lanes(const unsigned char *const *k)
+{
+  __m512i t=_mm512_castsi128_si512(_mm_loadu_si128((const __m128i *)k[0]));
+
+  t=_mm512_inserti32x4(t, _mm_loadu_si128((const __m128i *)k[1]), 1);
+  t=_mm512_inserti32x4(t, _mm_loadu_si128((const __m128i *)k[2]), 2);
+  return _mm512_inserti32x4(t, _mm_loadu_si128((const __m128i *)k[3]), 3);
+}
+
+//-------------------------------------------------------------------
+static inline void store_lanes(key_ctxt *const *kctxts, int r, __m512i t)
+{
+  _mm_storeu_si128((__m128i *)kctxts[0]->rk[r], _mm512_castsi512_si128(t));
+  _mm_storeu_si128((__m128i *)kctxts[1]->rk[r],
+                   _mm512_extracti32x4_epi32(t, 1));
+  _mm_storeu_si128((__m128i *)kctxts[2]->rk[r],
+                   _mm512_extracti32x4_epi32(t, 2));
+  _mm_storeu_si128((__m128i *)kctxts[3]->rk[r],
+                   _mm512_extracti32x4_epi32(t, 3));
+}
+
+//-------------------------------------------------------------------
+void aes128e_set_keys_vaes(key_ctxt *const *kctxts,
+                           const unsigned char *const *keys,
+                           unsigned int n)
+{
+  static const int rcon[AES128_ROUNDS]={0x01, 0x02, 0x04, 0x08, 0x10,
+                                        0x20, 0x40, 0x80, 0x1b, 0x36};
+  //RotWord of the last word into every word of a lane, see
+  //aes128e_set_keys_aesni()
+  const __m512i rot=_mm512_set1_epi32(0x0c0f0e0d);
+
+  for(; n>=VAES_BLOCKS; n-=VAES_BLOCKS, keys+=VAES_BLOCKS,
+                        kctxts+=VAES_BLOCKS)
+  {
+    __m512i t[VAES_REGS];
+
+    for(int j=0; j<VAES_REGS; j++)
+    {
+      t[j]=load_lanes(keys+VAES_LANES*j);
+      store_lanes(kctxts+VAES_LANES*j, 0, t[j]);
+    }
+    for(int r=1; r<=AES128_ROUNDS; r++)
+    {
+      __m512i rc=_mm512_set1_epi32(rcon[r-1]);
+
+      for(int j=0; j<VAES_REGS; j++)
+      {
+        __m512i w=_mm512_aesenclast_epi128(_mm512_shuffle_epi8(t[j], rot),
+                                           rc);
+
+        t[j]=_mm512_xor_si512(t[j], _mm512_bslli_epi128(t[j], 4));
+        t[j]=_mm512_xor_si512(t[j], _mm512_bslli_epi128(t[j], 4));
+        t[j]=_mm512_xor_si512(t[j], _mm512_bslli_epi128(t[j], 4));
+        t[j]=_mm512_xor_si512(t[j], w);
+        store_lanes(kctxts+VAES_LANES*j, r, t[j]);
+      }
+    }
+  }
+  aes128e_set_keys_aesni(kctxts, keys, n);
+}
+
+//-------------------------------------------------------------------
+void aes128e_ctr32_vaes(const key_ctxt *kctxt, unsigned char *out,
+                        const unsigned char *in, unsigned char *ctr,
+                        unsigned long nblocks)
+{
+  __m512i rk[AES128_ROUNDS+1];
+  __m512i b[VAES_REGS];
+  vaes_ctr vc;
+  uint32_t n= ((uint32_t)ctr[12] << 24) | ((uint32_t)ctr[13] << 16) |
+              ((uint32_t)ctr[14] << 8) | (uint32_t)ctr[15];
+  int nregs;
+
+  vaes_load_keys(kctxt, rk);
+  vaes_ctr_init(&vc, ctr, n);
+  n+=(uint32_t)nblocks;
+  for(; nblocks>=VAES_BLOCKS; nblocks-=VAES_BLOCKS, in+=16*VAES_BLOCKS,
+                              out+=16*VAES_BLOCKS)
+  {
+    for(int j=0; j<VAES_REGS; j++)
+      b[j]=vaes_ctr_next(&vc);
+    vaes_encrypt(rk, b, VAES_REGS);
+    for(int j=0; j<VAES_REGS; j++)
+      _mm512_storeu_si512(out+64*j,
+                          _mm512_xor_si512(b[j], _mm512_loadu_si512(in+64*j)));
+  }
+
+  nregs=(int)((nblocks+VAES_LANES-1)/VAES_LANES);
+  for(int j=0; j<nregs; j++)
+    b[j]=vaes_ctr_next(&vc);
+  vaes_encrypt(rk, b, nregs);
+  for(int j=0; j<nregs; j++)
+  {
+    __mmask64 m=vaes_mask(nblocks-VAES_LANES*j);
+
+    _mm512_mask_storeu_epi8(out+64*j, m,
+      _mm512_xor_si512(b[j], _mm512_maskz_loadu_epi8(m, in+64*j)));
+  }
+
+  ctr[12]=(unsigned char)(n >> 24);
+  ctr[13]=(unsigned char)(n >> 16);
+  ctr[14]=(unsigned char)(n >> 8);
+  ctr[15]=(unsigned char)n;
+}
+
+#else
+
+//built without VAES support, cpu_features() never selects these
+void aes128e_set_keys_vaes(key_ctxt *const *kctxts,
+                           const unsigned char *const *keys,
+                           unsigned int n)
+{
+  aes128e_set_keys_aesni(kctxts, keys, n);
+}
+
+void aes128e_blocks_vaes(const key_ctxt *kctxt, unsigned char *c,
+                         const unsigned char *p, unsigned long nblocks)
+{
+  aes128e_blocks_aesni(kctxt, c, p, nblocks);
+}
+
+void aes128e_ctr32_vaes(const key_ctxt *kctxt, unsigned char *out,
+                        const unsigned char *in, unsigned char *ctr,
+                        unsigned long nblocks)
+{
+  aes128e_ctr32_aesni(kctxt, out, in, ctr, nblocks);
+}
+
+#endif
+
+//end of file
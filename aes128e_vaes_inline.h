@@ -0,0 +1,92 @@
+#ifndef AES128E_VAES_INLINE_H
+#define AES128E_VAES_INLINE_H
+
+//-------------------------------------------------------------------
+// FILE: aes128e_vaes_inline.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  VAES helpers shared by the AVX-512 block cipher backend and the
+//  stitched VAES/VPCLMULQDQ GCM loop. a 512-bit register holds 4
+//  blocks, lane j in bytes 16*j..16*j+15. only for files compiled
+//  with the VAES_FLAGS of the Makefile
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include "aes128e.h"
+
+//blocks per 512-bit register
+#define VAES_LANES 4
+//registers kept in flight, 16 blocks per loop
+#define VAES_REGS 4
+#define VAES_BLOCKS (VAES_LANES*VAES_REGS)
+
+//counter blocks of a register, the 32-bit counters are kept little
+//endian in the last word of every lane and byte swapped into base
+typedef struct
+{
+  __m512i base;//counter block with the last word cleared
+  __m512i n;//counters n..n+3, last word of each lane
+  __m512i step;//VAES_LANES in the last word of each lane
+  __m512i swap;//shuffle moving the swapped last word into place
+}vaes_ctr;
+
+//-------------------------------------------------------------------
+static inline void vaes_load_keys(const key_ctxt *kctxt, __m512i *rk)
+{
+  for(int r=0; r<=AES128_ROUNDS; r++)
+    rk[r]=_mm512_broadcast_i32x4(
+            _mm_loadu_si128((const __m128i *)kctxt->rk[r]));
+}
+
+//-------------------------------------------------------------------
+static inline void vaes_ctr_init(vaes_ctr *vc, const unsigned char *ctr,
+                                 uint32_t n)
+{
+  __m128i b=_mm_insert_epi32(_mm_loadu_si128((const __m128i *)ctr), 0, 3);
+
+  vc->base=_mm512_broadcast_i32x4(b);
+  vc->n=_mm512_set_epi32((int)(n+3), 0, 0, 0, (int)(n+2), 0, 0, 0,
+                         (int)(n+1), 0, 0, 0, (int)n, 0, 0, 0);
+  vc->step=_mm512_broadcast_i32x4(_mm_set_epi32(VAES_LANES, 0, 0, 0));
+  vc->swap=_mm512_broadcast_i32x4(_mm_set_epi8(12, 13, 14, 15,
+                                               -128, -128, -128, -128,
+                                               -128, -128, -128, -128,
+                                               -128, -128, -128, -128));
+}
+
+//-------------------------------------------------------------------
+//next 4 counter blocks, the 32-bit add wraps modulo 2^32 as inc32
+static inline __m512i vaes_ctr_next(vaes_ctr *vc)
+{
+  __m512i b=_mm512_or_si512(vc->base, _mm512_shuffle_epi8(vc->n, vc->swap));
+
+  vc->n=_mm512_add_epi32(vc->n, vc->step);
+  return b;
+}
+
+//-------------------------------------------------------------------
+//encrypts nregs registers with the rounds interleaved
+static inline void vaes_encrypt(const __m512i *rk, __m512i *b, int nregs)
+{
+  for(int j=0; j<nregs; j++)
+    b[j]=_mm512_xor_si512(b[j], rk[0]);
+  for(int r=1; r<AES128_ROUNDS; r++)
+    for(int j=0; j<nregs; j++)
+      b[j]=_mm512_aesenc_epi128(b[j], rk[r]);
+  for(int j=0; j<nregs; j++)
+    b[j]=_mm512_aesenclast_epi128(b[j], rk[AES128_ROUNDS]);
+}
+
+//-------------------------------------------------------------------
+//byte mask of the first nblocks (at most VAES_LANES) blocks of a
+//register
+static inline __mmask64 vaes_mask(unsigned long nblocks)
+{
+  return (nblocks>=VAES_LANES) ? ~(__mmask64)0 :
+         (((__mmask64)1 << (16*nblocks))-1);
+}
+
+#endif
@@ -3,32 +3,37 @@
 // AUTHOR: Suhas Thejaswi
 // DATE: 12-nov-2014
 // MODIFIED: 12-nov-2014 //gmul initial version completed and tested
+//           17-oct-2026 //key expanded once per call, gctr through
+//                       //aes128e_ctr32
+//           17-oct-2026 //gcm key context with selectable GHASH
+//           17-oct-2026 //PCLMULQDQ GHASH selected at runtime
+//           17-oct-2026 //streaming interface, aes128gcm without VLAs
+//           17-oct-2026 //single pass encrypt and hash of whole blocks
+//           17-oct-2026 //decryption, verify first and single pass
+//           17-oct-2026 //segment helpers for parallel GCM
+//           17-oct-2026 //multi lane GHASH for batches
+//           17-oct-2026 //key context footprint
+//           17-oct-2026 //AVX-512 VAES/VPCLMULQDQ single pass loop
+//           17-oct-2026 //stage counters replace the log macros
+//           17-oct-2026 //GMAC one shot and streaming
+//           17-oct-2026 //bulk key setup
+//           17-oct-2026 //constant time integer multiply GHASH
+//           17-oct-2026 //table sizes shared with the precompute tiers
+//           17-oct-2026 //constant time segment hash merge
+//           17-oct-2026 //dropped the GHASH lanes of the batch API
+//           17-oct-2026 //key setup reports a missing GHASH table
 // DESCRIPTION:
 //  This file is the implementation of the Galois counter mode for 
 //  authentication
 //-------------------------------------------------------------------
 
 #include "aes128gcm.h"
+#include "ghash_impl.h"
+#include "aes128gcm_impl.h"
+#include "cpu_features.h"
+#include "aes128gcm_stats.h"
 #include<string.h>
 
-//To enable log compile with -DENABLE_LOG option
-#ifdef ENABLE_LOG
-  #define LOG_ENABLED 0
-  #define INFO_ENABLED 0
-#else
-  #define LOG_ENABLED 0
-#endif
-
-#define print_array(a, n) \
-        if(INFO_ENABLED) \
-        { \
-          fprintf(stdout,"[INFO] %s ,%s:%d \n %s:" \
-                  ,__FILE__, __FUNCTION__, __LINE__, #a); \
-          for(int i=0;i<n;i++) \
-            fprintf(stdout,"%02x ",a[i]); \
-          fprintf(stdout,"\n"); \
-        }
-
 #define init_array(a, n) \
         for(int i=0;i<n;i++) \
           a[i]=0x00;
@@ -37,21 +42,32 @@
         for(int i=0;i<n;i++) \
           dst[i]=src[i];
 
-#define log_func_enter() \
-        if(LOG_ENABLED) \
-        { \
-          fprintf( stdout, "[LOG] %s ,%s:%d enter\n" \
-                    ,__FILE__,__FUNCTION__, __LINE__); \
-        }
-
-#define log_func_exit() \
-        if(LOG_ENABLED) \
-        { \
-          fprintf( stdout, "[LOG] %s ,%s:%d exit\n" \
-                    ,__FILE__,__FUNCTION__, __LINE__); \
-        }
-
 #define BLK_LEN 16
+//blocks encrypted and then hashed at once by the portable single
+//pass loop, small enough to stay in L1
+#define FUSE_BLOCKS 32
+//keys set up together by gcm_init_keys()
+#define KEY_CHUNK 64
+
+//------------------------------------------------------------------
+size_t gcm_htab_size(int backend)
+{
+  switch(backend)
+  {
+    case GHASH_TAB4:
+      return GHASH_TAB4_SIZE;
+    case GHASH_TAB8:
+      return GHASH_TAB8_SIZE;
+    case GHASH_CLMUL:
+      return GHASH_CLMUL_SIZE;
+    case GHASH_VCLMUL:
+      return GHASH_VCLMUL_SIZE;
+    case GHASH_CT:
+      return GHASH_CT_SIZE;
+    default:
+      return 0;
+  }
+}
 //------------------------------------------------------------------
 void aes128gcm( unsigned char *ciphertext, //out
                 unsigned char *tag, //out
@@ -62,62 +78,726 @@ void aes128gcm( unsigned char *ciphertext, //out
                 const unsigned char* add_data, 
                 const unsigned long len_ad) 
 {
-  log_func_enter();
-  unsigned char counter_0[BLK_LEN];
-  unsigned char A[BLK_LEN*len_ad];
-  unsigned char P[BLK_LEN*len_p];
-  unsigned char C[BLK_LEN*len_p];
-  unsigned char empty[BLK_LEN];
-  unsigned char H[BLK_LEN];
+  gcm_ctxt gctxt;
 
-  unsigned long len_x=(len_p+len_ad+1);
-  unsigned char X[BLK_LEN*len_x];
-  unsigned char Y[BLK_LEN*len_x];
-  unsigned char enc_counter[BLK_LEN];
+  //no output that could pass for a valid one without a GHASH table
+  if(gcm_init_key(&gctxt, k))
+  {
+    memset(ciphertext, 0, BLK_LEN*len_p);
+    memset(tag, 0, BLK_LEN);
+    gcm_clear_key(&gctxt);
+    return;
+  }
+  aes128gcm_encrypt(&gctxt, ciphertext, tag, IV, plaintext, BLK_LEN*len_p,
+                    add_data, BLK_LEN*len_ad);
+  gcm_clear_key(&gctxt);
 
+}
 
-  //init counter
-  memcpy(counter_0, IV, 12);
+//------------------------------------------------------------------
+int aes128gcm_encrypt( const gcm_ctxt *gctxt,
+                       unsigned char *ciphertext,
+                       unsigned char *tag,
+                       const unsigned char *IV,
+                       const unsigned char *plaintext,
+                       const unsigned long len_p,
+                       const unsigned char *add_data,
+                       const unsigned long len_ad)
+{
+  gcm_stream st;
+
+  gcm_init(&st, gctxt, IV);
+  gcm_update_aad(&st, add_data, len_ad);
+  if(gcm_update(&st, ciphertext, plaintext, len_p))
+  {
+    aes128e_wipe(&st, sizeof(st));
+    return -1;
+  }
+  gcm_final(&st, tag);
+  return 0;
+}
+
+//------------------------------------------------------------------
+void gcm_init(gcm_stream *st, const gcm_ctxt *gctxt,
+              const unsigned char *IV)
+{
+  st->gctxt=gctxt;
+
+  //J0=IV||0^31||1, data starts at inc32(J0)
+  memcpy(st->J0, IV, 12);
   for(int i=12; i<15; i++)
-    counter_0[i]=0x00;
-  counter_0[15]= 0x01;
+    st->J0[i]=0x00;
+  st->J0[15]=0x01;
+  memcpy(st->ctr, st->J0, BLK_LEN);
+  inc_ctr(st->ctr);
+
+  init_array(st->Y, BLK_LEN);
+  st->len_ad=0;
+  st->len_p=0;
+  st->buf_len=0;
+  st->in_data=0;
+}
+
+//------------------------------------------------------------------
+int gcm_update_aad(gcm_stream *st, const unsigned char *add_data,
+                   unsigned long len_ad)
+{
+  unsigned long nblocks;
+
+  if(st->in_data)
+    return -1;
+  st->len_ad+=len_ad;
+
+  //complete a pending partial block first
+  if(st->buf_len)
+  {
+    while(len_ad && st->buf_len<BLK_LEN)
+    {
+      st->buf[st->buf_len++]=*add_data++;
+      len_ad--;
+    }
+    if(st->buf_len<BLK_LEN)
+      return 0;
+    gcm_ghash(st->gctxt, st->Y, st->buf, 1);
+    st->buf_len=0;
+  }
+
+  nblocks=len_ad/BLK_LEN;
+  gcm_ghash(st->gctxt, st->Y, add_data, nblocks);
+  add_data+=BLK_LEN*nblocks;
+  len_ad-=BLK_LEN*nblocks;
+
+  if(len_ad)
+    memcpy(st->buf, add_data, len_ad);
+  st->buf_len=len_ad;
+  return 0;
+}
+
+//------------------------------------------------------------------
+//closes the AAD part, a partial AAD block is zero padded
+static void gcm_start_data(gcm_stream *st)
+{
+  if(st->buf_len)
+  {
+    memset(&st->buf[st->buf_len], 0, BLK_LEN-st->buf_len);
+    gcm_ghash(st->gctxt, st->Y, st->buf, 1);
+    st->buf_len=0;
+  }
+  st->in_data=1;
+}
+
+//------------------------------------------------------------------
+//encrypts and hashes whole blocks in a single pass over the data
+static void gcm_encrypt_blocks(gcm_stream *st, unsigned char *out,
+                               const unsigned char *in,
+                               unsigned long nblocks)
+{
+  const gcm_ctxt *g=st->gctxt;
+
+  if(g->kctxt.backend==AES128E_VAES && g->ghash==GHASH_VCLMUL)
+  {
+    unsigned long ngroups=nblocks/GHASH_VCLMUL_POWERS;
+
+    GCM_STAT_BEGIN(t);
+    gcm_stitch_vaes(&g->kctxt, g->htab, out, in, st->ctr, st->Y, ngroups);
+    GCM_STAT_END(t, GCM_STAGE_STITCH, BLK_LEN*GHASH_VCLMUL_POWERS*ngroups);
+    if(ngroups)
+      GCM_STAT_PATH(GCM_PATH_STITCH_VAES);
+    in+=BLK_LEN*GHASH_VCLMUL_POWERS*ngroups;
+    out+=BLK_LEN*GHASH_VCLMUL_POWERS*ngroups;
+    nblocks-=GHASH_VCLMUL_POWERS*ngroups;
+  }
+  if(g->kctxt.backend==AES128E_AESNI && g->ghash==GHASH_CLMUL)
+  {
+    unsigned long ngroups=nblocks/GHASH_CLMUL_POWERS;
+
+    GCM_STAT_BEGIN(t);
+    gcm_stitch_aesni(&g->kctxt, g->htab, out, in, st->ctr, st->Y,
+                     ngroups);
+    GCM_STAT_END(t, GCM_STAGE_STITCH, BLK_LEN*GHASH_CLMUL_POWERS*ngroups);
+    if(ngroups)
+      GCM_STAT_PATH(GCM_PATH_STITCH_AESNI);
+    in+=BLK_LEN*GHASH_CLMUL_POWERS*ngroups;
+    out+=BLK_LEN*GHASH_CLMUL_POWERS*ngroups;
+    nblocks-=GHASH_CLMUL_POWERS*ngroups;
+  }
+
+  //hash every group while its ciphertext is still in L1
+  if(nblocks)
+    GCM_STAT_PATH(GCM_PATH_GENERIC);
+  while(nblocks)
+  {
+    unsigned long n= (nblocks < FUSE_BLOCKS) ? nblocks : FUSE_BLOCKS;
+
+    aes128e_ctr32(&g->kctxt, out, in, st->ctr, n);
+    gcm_ghash(g, st->Y, out, n);
+    in+=BLK_LEN*n;
+    out+=BLK_LEN*n;
+    nblocks-=n;
+  }
+}
+
+//------------------------------------------------------------------
+//decrypts and hashes whole blocks in a single pass, the ciphertext is
+//hashed before it is overwritten when decrypting in place
+static void gcm_decrypt_blocks(gcm_stream *st, unsigned char *out,
+                               const unsigned char *in,
+                               unsigned long nblocks)
+{
+  const gcm_ctxt *g=st->gctxt;
 
-  memcpy(A, add_data, BLK_LEN*len_ad);
-  memcpy(P, plaintext, BLK_LEN*len_p);
-  init_array(C, BLK_LEN*len_p);
+  if(g->kctxt.backend==AES128E_VAES && g->ghash==GHASH_VCLMUL)
+  {
+    unsigned long ngroups=nblocks/GHASH_VCLMUL_POWERS;
+
+    GCM_STAT_BEGIN(t);
+    gcm_stitch_vaes_dec(&g->kctxt, g->htab, out, in, st->ctr, st->Y,
+                        ngroups);
+    GCM_STAT_END(t, GCM_STAGE_STITCH, BLK_LEN*GHASH_VCLMUL_POWERS*ngroups);
+    if(ngroups)
+      GCM_STAT_PATH(GCM_PATH_STITCH_VAES);
+    in+=BLK_LEN*GHASH_VCLMUL_POWERS*ngroups;
+    out+=BLK_LEN*GHASH_VCLMUL_POWERS*ngroups;
+    nblocks-=GHASH_VCLMUL_POWERS*ngroups;
+  }
+  if(g->kctxt.backend==AES128E_AESNI && g->ghash==GHASH_CLMUL)
+  {
+    unsigned long ngroups=nblocks/GHASH_CLMUL_POWERS;
+
+    GCM_STAT_BEGIN(t);
+    gcm_stitch_aesni_dec(&g->kctxt, g->htab, out, in, st->ctr, st->Y,
+                         ngroups);
+    GCM_STAT_END(t, GCM_STAGE_STITCH, BLK_LEN*GHASH_CLMUL_POWERS*ngroups);
+    if(ngroups)
+      GCM_STAT_PATH(GCM_PATH_STITCH_AESNI);
+    in+=BLK_LEN*GHASH_CLMUL_POWERS*ngroups;
+    out+=BLK_LEN*GHASH_CLMUL_POWERS*ngroups;
+    nblocks-=GHASH_CLMUL_POWERS*ngroups;
+  }
+
+  if(nblocks)
+    GCM_STAT_PATH(GCM_PATH_GENERIC);
+  while(nblocks)
+  {
+    unsigned long n= (nblocks < FUSE_BLOCKS) ? nblocks : FUSE_BLOCKS;
+
+    gcm_ghash(g, st->Y, in, n);
+    aes128e_ctr32(&g->kctxt, out, in, st->ctr, n);
+    in+=BLK_LEN*n;
+    out+=BLK_LEN*n;
+    nblocks-=n;
+  }
+}
+
+//------------------------------------------------------------------
+//common part of gcm_update() and gcm_update_decrypt(). the GHASH
+//always runs over the ciphertext side
+static int gcm_crypt(gcm_stream *st, unsigned char *out,
+                     const unsigned char *in, unsigned long len,
+                     int decrypt)
+{
+  unsigned long nblocks;
+
+  if(len > GCM_MAX_PLAINTEXT-st->len_p)
+    return -1;
+  if(!st->in_data)
+    gcm_start_data(st);
+  st->len_p+=len;
+
+  //use up the keystream of a pending partial block
+  if(st->buf_len)
+  {
+    while(len && st->buf_len<BLK_LEN)
+    {
+      unsigned char x= *in++;
+      *out= x ^ st->ks[st->buf_len];
+      st->buf[st->buf_len++]= decrypt ? x : *out;
+      out++;
+      len--;
+    }
+    if(st->buf_len<BLK_LEN)
+      return 0;
+    gcm_ghash(st->gctxt, st->Y, st->buf, 1);
+    st->buf_len=0;
+  }
+
+  nblocks=len/BLK_LEN;
+  if(decrypt)
+    gcm_decrypt_blocks(st, out, in, nblocks);
+  else
+    gcm_encrypt_blocks(st, out, in, nblocks);
+  in+=BLK_LEN*nblocks;
+  out+=BLK_LEN*nblocks;
+  len-=BLK_LEN*nblocks;
+
+  //a trailing partial block keeps the rest of its keystream
+  if(len)
+  {
+    init_array(st->ks, BLK_LEN);
+    aes128e_ctr32(&st->gctxt->kctxt, st->ks, st->ks, st->ctr, 1);
+    for(unsigned long i=0; i<len; i++)
+    {
+      unsigned char x= in[i];
+      out[i]= x ^ st->ks[i];
+      st->buf[i]= decrypt ? x : out[i];
+    }
+    st->buf_len=len;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------
+int gcm_update(gcm_stream *st, unsigned char *ciphertext,
+               const unsigned char *plaintext, unsigned long len_p)
+{
+  return gcm_crypt(st, ciphertext, plaintext, len_p, 0);
+}
+
+//------------------------------------------------------------------
+int gcm_update_decrypt(gcm_stream *st, unsigned char *plaintext,
+                       const unsigned char *ciphertext, unsigned long len_c)
+{
+  return gcm_crypt(st, plaintext, ciphertext, len_c, 1);
+}
+
+//------------------------------------------------------------------
+void gcm_segment(const gcm_ctxt *gctxt, unsigned char *out,
+                 const unsigned char *in, unsigned long len,
+                 const unsigned char *ctr, unsigned char *Y, int decrypt)
+{
+  gcm_stream st;
+
+  st.gctxt=gctxt;
+  memcpy(st.ctr, ctr, BLK_LEN);
+  init_array(st.Y, BLK_LEN);
+  st.len_ad=0;
+  st.len_p=0;
+  st.buf_len=0;
+  st.in_data=1;
+
+  gcm_crypt(&st, out, in, len, decrypt);
+  if(st.buf_len)
+  {
+    memset(&st.buf[st.buf_len], 0, BLK_LEN-st.buf_len);
+    gcm_ghash(gctxt, st.Y, st.buf, 1);
+  }
+  memcpy(Y, st.Y, BLK_LEN);
+  aes128e_wipe(&st, sizeof(st));
+}
+
+//------------------------------------------------------------------
+void gcm_mul_hpow(unsigned char *Y, const unsigned char *H,
+                  unsigned long long e)
+{
+  unsigned char p[BLK_LEN];
+
+  //square and multiply, Y=Y*H^e. only the public exponent steers
+  //the loop, the multiplies are constant time
+  memcpy(p, H, BLK_LEN);
+  for(; e; e>>=1)
+  {
+    if(e & 1)
+      ghash_ct_mul(Y, Y, p);
+    if(e>1)
+      ghash_ct_mul(p, p, p);
+  }
+  aes128e_wipe(p, sizeof(p));
+}
+
+//------------------------------------------------------------------
+//writes the 64-bit big endian bit count of len bytes
+static void put_bitlen(unsigned char *out, unsigned long long len)
+{
+  len*=8;
+  for(int i=7; i>=0; i--, len>>=8)
+    out[i]=(unsigned char)len;
+}
+
+//------------------------------------------------------------------
+void gcm_final(gcm_stream *st, unsigned char *tag)
+{
+  unsigned char len_blk[BLK_LEN];
+  unsigned char enc_J0[BLK_LEN];
+  GCM_STAT_BEGIN(t);
+
+  if(!st->in_data)
+    gcm_start_data(st);
+  if(st->buf_len)
+  {
+    memset(&st->buf[st->buf_len], 0, BLK_LEN-st->buf_len);
+    gcm_ghash(st->gctxt, st->Y, st->buf, 1);
+  }
 
-  gctr(P, k, counter_0, len_p, ciphertext);
+  put_bitlen(len_blk, st->len_ad);
+  put_bitlen(&len_blk[8], st->len_p);
+  gcm_ghash(st->gctxt, st->Y, len_blk, 1);
 
-  // initial value of H
+  aes128e_blocks(&st->gctxt->kctxt, enc_J0, st->J0, 1);
+  xor_128(enc_J0, st->Y, tag);
+
+  aes128e_wipe(enc_J0, sizeof(enc_J0));
+  aes128e_wipe(st, sizeof(*st));
+  GCM_STAT_END(t, GCM_STAGE_TAG, BLK_LEN);
+}
+
+//------------------------------------------------------------------
+int gcm_final_verify(gcm_stream *st, const unsigned char *tag)
+{
+  unsigned char calc[BLK_LEN];
+  int ok;
+
+  gcm_final(st, calc);
+  ok=gcm_tag_equal(calc, tag, BLK_LEN);
+  aes128e_wipe(calc, sizeof(calc));
+  return ok ? 0 : -1;
+}
+
+//------------------------------------------------------------------
+int gcm_tag_equal(const unsigned char *a, const unsigned char *b,
+                  unsigned long len)
+{
+  //no early exit, the time does not depend on where they differ
+  volatile unsigned char diff=0;
+
+  for(unsigned long i=0; i<len; i++)
+    diff|= a[i] ^ b[i];
+  return (int)(1 & (((unsigned int)diff - 1) >> 8));
+}
+
+//------------------------------------------------------------------
+int aes128gcm_decrypt( const gcm_ctxt *gctxt,
+                       unsigned char *plaintext,
+                       const unsigned char *tag,
+                       const unsigned char *IV,
+                       const unsigned char *ciphertext,
+                       const unsigned long len_c,
+                       const unsigned char *add_data,
+                       const unsigned long len_ad,
+                       int mode)
+{
+  gcm_stream st;
+
+  if(len_c > GCM_MAX_PLAINTEXT)
+    return -1;
+
+  if(mode==GCM_VERIFY_FIRST)
+  {
+    unsigned char calc[BLK_LEN];
+    unsigned char ctr[BLK_LEN];
+
+    //authenticate with GHASH alone, the payload is only decrypted
+    //once the tag matched
+    gcm_init(&st, gctxt, IV);
+    gcm_update_aad(&st, add_data, len_ad);
+    gcm_start_data(&st);
+    gcm_ghash(gctxt, st.Y, ciphertext, len_c/BLK_LEN);
+    if(len_c%BLK_LEN)
+    {
+      init_array(st.buf, BLK_LEN);
+      memcpy(st.buf, &ciphertext[len_c-len_c%BLK_LEN], len_c%BLK_LEN);
+      st.buf_len=len_c%BLK_LEN;
+    }
+    st.len_p=len_c;
+    memcpy(ctr, st.ctr, BLK_LEN);
+    gcm_final(&st, calc);
+    if(!gcm_tag_equal(calc, tag, BLK_LEN))
+    {
+      //calc is the valid tag of the forged ciphertext
+      aes128e_wipe(calc, sizeof(calc));
+      return -1;
+    }
+    aes128e_wipe(calc, sizeof(calc));
+
+    aes128e_ctr32(&gctxt->kctxt, plaintext, ciphertext, ctr, len_c/BLK_LEN);
+    if(len_c%BLK_LEN)
+    {
+      unsigned char ks[BLK_LEN];
+      unsigned long off=len_c-len_c%BLK_LEN;
+
+      init_array(ks, BLK_LEN);
+      aes128e_ctr32(&gctxt->kctxt, ks, ks, ctr, 1);
+      for(unsigned long i=0; i<len_c%BLK_LEN; i++)
+        plaintext[off+i]= ciphertext[off+i] ^ ks[i];
+      aes128e_wipe(ks, sizeof(ks));
+    }
+    return 0;
+  }
+
+  //single pass, the plaintext is withdrawn if the tag does not match
+  gcm_init(&st, gctxt, IV);
+  gcm_update_aad(&st, add_data, len_ad);
+  gcm_update_decrypt(&st, plaintext, ciphertext, len_c);
+  if(gcm_final_verify(&st, tag))
+  {
+    aes128e_wipe(plaintext, len_c);
+    return -1;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------
+int aes128gmac(const gcm_ctxt *gctxt, unsigned char *tag,
+               const unsigned char *IV, const unsigned char *data,
+               unsigned long len)
+{
+  unsigned char Y[BLK_LEN], blk[BLK_LEN], J0[BLK_LEN];
+  unsigned long n=len%BLK_LEN;
+
+  //whole blocks straight from data, no stream state
+  init_array(Y, BLK_LEN);
+  gcm_ghash(gctxt, Y, data, len/BLK_LEN);
+  if(n)
+  {
+    init_array(blk, BLK_LEN);
+    memcpy(blk, &data[len-n], n);
+    gcm_ghash(gctxt, Y, blk, 1);
+  }
+  put_bitlen(blk, len);
+  put_bitlen(&blk[8], 0);
+  gcm_ghash(gctxt, Y, blk, 1);
+
+  memcpy(J0, IV, 12);
+  for(int i=12; i<15; i++)
+    J0[i]=0x00;
+  J0[15]=0x01;
+  aes128e_blocks(&gctxt->kctxt, blk, J0, 1);
+  xor_128(blk, Y, tag);
+
+  aes128e_wipe(blk, sizeof(blk));
+  aes128e_wipe(Y, sizeof(Y));
+  return 0;
+}
+
+//------------------------------------------------------------------
+int aes128gmac_verify(const gcm_ctxt *gctxt, const unsigned char *tag,
+                      const unsigned char *IV, const unsigned char *data,
+                      unsigned long len)
+{
+  unsigned char calc[BLK_LEN];
+  int ok;
+
+  aes128gmac(gctxt, calc, IV, data, len);
+  ok=gcm_tag_equal(calc, tag, BLK_LEN);
+  aes128e_wipe(calc, sizeof(calc));
+  return ok ? 0 : -1;
+}
+
+//------------------------------------------------------------------
+void gmac_init(gcm_stream *st, const gcm_ctxt *gctxt,
+               const unsigned char *IV)
+{
+  gcm_init(st, gctxt, IV);
+}
+
+//------------------------------------------------------------------
+void gmac_update(gcm_stream *st, const unsigned char *data,
+                 unsigned long len)
+{
+  //GMAC data is GCM associated data, partial blocks are carried
+  gcm_update_aad(st, data, len);
+}
+
+//------------------------------------------------------------------
+void gmac_final(gcm_stream *st, unsigned char *tag)
+{
+  gcm_final(st, tag);
+}
+
+//------------------------------------------------------------------
+int gmac_final_verify(gcm_stream *st, const unsigned char *tag)
+{
+  return gcm_final_verify(st, tag);
+}
+
+//------------------------------------------------------------------
+//table of backend, or of the small GHASH_CT if it cannot be built.
+//the context is never left on the variable time GHASH_REF silently
+static int init_ghash(gcm_ctxt *gctxt, int backend)
+{
+  if(!gcm_set_ghash(gctxt, backend) || !gcm_set_ghash(gctxt, GHASH_CT))
+    return 0;
+  return -1;
+}
+
+//------------------------------------------------------------------
+int gcm_init_key(gcm_ctxt *gctxt, const unsigned char *k)
+{
+  unsigned char empty[BLK_LEN];
+  int ret;
+  GCM_STAT_BEGIN(t);
+
+  aes128e_set_key(&gctxt->kctxt, k);
   init_array(empty, BLK_LEN);
-  aes128e(H, empty, k);
+  aes128e_blocks(&gctxt->kctxt, gctxt->H, empty, 1);
 
-  memcpy(X, add_data, BLK_LEN*len_ad);
-  memcpy(&X[BLK_LEN*(len_ad)], ciphertext, BLK_LEN*len_p);
+  gctxt->ghash=GHASH_REF;
+  gctxt->htab=NULL;
+  ret=init_ghash(gctxt, gcm_default_ghash());
+  GCM_STAT_END(t, GCM_STAGE_KEY, BLK_LEN);
+  return ret;
+}
 
-  // getting the 8 byte version of length
-  unsigned char len_ad_arr[8];
-  unsigned char len_p_arr[8];
-  long_to_carray(len_ad, len_ad_arr);
-  long_to_carray(len_p, len_p_arr);
+//------------------------------------------------------------------
+int gcm_init_keys(gcm_ctxt *const *gctxts, const unsigned char *const *keys,
+                  unsigned int n)
+{
+  unsigned char zero[BLK_LEN*KEY_CHUNK], H[BLK_LEN*KEY_CHUNK];
+  key_ctxt *kctxts[KEY_CHUNK];
+  void *htab[KEY_CHUNK];
+  const unsigned char *hp[KEY_CHUNK];
+  int ghash=gcm_default_ghash();
+  size_t len=gcm_htab_size(ghash);
+  int ret=0;
+  GCM_STAT_BEGIN(t);
+
+  memset(zero, 0, sizeof(zero));
+  for(unsigned int i=0; i<n; i+=KEY_CHUNK)
+  {
+    unsigned int m= (n-i < KEY_CHUNK) ? n-i : KEY_CHUNK, nt=0;
 
-  //copy length
-  memcpy(&X[BLK_LEN*(len_ad+len_p)], len_ad_arr, 8);
-  memcpy(&X[BLK_LEN*(len_ad+len_p)+8], len_p_arr, 8);
+    //round keys, then all H=E(K,0^128) in one multi key pass
+    for(unsigned int j=0; j<m; j++)
+      kctxts[j]=&gctxts[i+j]->kctxt;
+    aes128e_set_keys(kctxts, &keys[i], m);
+    aes128e_blocks_multi((const key_ctxt *const *)kctxts, H, zero, m);
 
-  ghash_128(H, X, len_x, Y);
-  aes128e(enc_counter, counter_0, k);
+    for(unsigned int j=0; j<m; j++)
+    {
+      gcm_ctxt *g=gctxts[i+j];
+
+      memcpy(g->H, &H[BLK_LEN*j], BLK_LEN);
+      g->ghash=GHASH_REF;
+      g->htab=NULL;
+      //the CLMUL power tables are built below, side by side
+      if((ghash==GHASH_CLMUL || ghash==GHASH_VCLMUL) &&
+         (htab[nt]=malloc(len)))
+      {
+        g->htab=htab[nt];
+        g->ghash=ghash;
+        hp[nt++]=g->H;
+        GCM_STAT_GHASH(ghash);
+      }
+      else if(init_ghash(g, ghash))
+        ret=-1;
+    }
+    if(ghash==GHASH_CLMUL)
+      ghash_clmul_init_lanes(htab, hp, nt);
+    else if(ghash==GHASH_VCLMUL)
+      ghash_vclmul_init_lanes(htab, hp, nt);
+  }
+  aes128e_wipe(H, sizeof(H));
+  GCM_STAT_END(t, GCM_STAGE_KEY, (unsigned long long)BLK_LEN*n);
+  return ret;
+}
 
-  xor_128(enc_counter, Y, tag);
+//------------------------------------------------------------------
+int gcm_default_ghash(void)
+{
+  if((cpu_features() & (CPU_PCLMUL|CPU_SSE41|CPU_VAES512)) ==
+     (CPU_PCLMUL|CPU_SSE41|CPU_VAES512))
+    return GHASH_VCLMUL;
+  if((cpu_features() & (CPU_PCLMUL|CPU_SSE41)) == (CPU_PCLMUL|CPU_SSE41))
+    return GHASH_CLMUL;
+  return GHASH_CT;
+}
 
-  log_func_exit();
+//------------------------------------------------------------------
+int gcm_set_ghash(gcm_ctxt *gctxt, int backend)
+{
+  size_t len=gcm_htab_size(backend);
+  void *htab=NULL;
+
+  if(backend!=GHASH_REF && backend!=GHASH_TAB4 && backend!=GHASH_TAB8 &&
+     backend!=GHASH_CLMUL && backend!=GHASH_VCLMUL && backend!=GHASH_CT)
+    return -1;
+  if(backend==GHASH_CLMUL &&
+     (cpu_features() & (CPU_PCLMUL|CPU_SSE41)) != (CPU_PCLMUL|CPU_SSE41))
+    return -1;
+  if(backend==GHASH_VCLMUL &&
+     (cpu_features() & (CPU_PCLMUL|CPU_SSE41|CPU_VAES512)) !=
+     (CPU_PCLMUL|CPU_SSE41|CPU_VAES512))
+    return -1;
+  if(len && !(htab=malloc(len)))
+    return -1;
+  if(backend==GHASH_TAB4)
+    ghash_tab4_init(htab, gctxt->H);
+  else if(backend==GHASH_TAB8)
+    ghash_tab8_init(htab, gctxt->H);
+  else if(backend==GHASH_CLMUL)
+    ghash_clmul_init(htab, gctxt->H);
+  else if(backend==GHASH_VCLMUL)
+    ghash_vclmul_init(htab, gctxt->H);
+  else if(backend==GHASH_CT)
+    ghash_ct_init(htab, gctxt->H);
+
+  //drop the table of the previous backend
+  if(gctxt->htab)
+  {
+    aes128e_wipe(gctxt->htab, gcm_htab_size(gctxt->ghash));
+    free(gctxt->htab);
+  }
+  gctxt->htab=htab;
+  gctxt->ghash=backend;
+  GCM_STAT_GHASH(backend);
+  return 0;
+}
+
+//------------------------------------------------------------------
+void gcm_ghash(const gcm_ctxt *gctxt, unsigned char *Y,
+               const unsigned char *X, unsigned long nblocks)
+{
+  unsigned char xor[BLK_LEN];
+  GCM_STAT_BEGIN(t);
+
+  switch(gctxt->ghash)
+  {
+    case GHASH_TAB4:
+      ghash_tab4(gctxt->htab, Y, X, nblocks);
+      break;
+    case GHASH_TAB8:
+      ghash_tab8(gctxt->htab, Y, X, nblocks);
+      break;
+    case GHASH_CLMUL:
+      ghash_clmul(gctxt->htab, Y, X, nblocks);
+      break;
+    case GHASH_VCLMUL:
+      ghash_vclmul(gctxt->htab, Y, X, nblocks);
+      break;
+    case GHASH_CT:
+      ghash_ct(gctxt->htab, Y, X, nblocks);
+      break;
+    default:
+      for(unsigned long i=0; i<nblocks; i++) //Y=(X^Y)*H
+      {
+        xor_128(Y, &X[i*BLK_LEN], xor);
+        gmul_128(xor, gctxt->H, Y);
+      }
+      break;
+  }
+  GCM_STAT_END(t, GCM_STAGE_GHASH, BLK_LEN*nblocks);
+}
+
+//------------------------------------------------------------------
+size_t gcm_key_footprint(const gcm_ctxt *gctxt)
+{
+  return sizeof(*gctxt)+(gctxt->htab ? gcm_htab_size(gctxt->ghash) : 0);
+}
+
+//------------------------------------------------------------------
+void gcm_clear_key(gcm_ctxt *gctxt)
+{
+  if(gctxt->htab)
+  {
+    aes128e_wipe(gctxt->htab, gcm_htab_size(gctxt->ghash));
+    free(gctxt->htab);
+  }
+  aes128e_wipe(gctxt, sizeof(*gctxt));
 }
 
 //------------------------------------------------------------------
 void long_to_carray( const unsigned long num, 
                         unsigned char *output)
 {
-  log_func_enter();
   //Assuming: max size value of num as 2^32-1
   //mulitplication by 128 wont exceed the long range
   unsigned int endian=0x01;
@@ -138,7 +818,6 @@ void long_to_carray( const unsigned long num,
       output[i]= *(p++);
   }
 
-  log_func_exit();
 }
 
 //------------------------------------------------------------------
@@ -149,29 +828,36 @@ void gctr( const unsigned char *P, //plain text
            unsigned char *output //output
            )
 {
-  log_func_enter();
+  key_ctxt kctxt;
+
+  aes128e_set_key(&kctxt, key);
+  gctr_key(P, &kctxt, counter, len_p, output);
+  aes128e_clear_key(&kctxt);
+}
+
+//------------------------------------------------------------------
+void gctr_key( const unsigned char *P, //plain text
+               const key_ctxt *kctxt, //expanded key
+               const unsigned char *counter, //ICB
+               const unsigned long len_p, //length of plain text
+               unsigned char *output //output
+               )
+{
   unsigned char ctr[BLK_LEN];
-  unsigned char enc_ctr[BLK_LEN];
   if(len_p)
   {
     for(int i=0; i<BLK_LEN;i++)
       ctr[i]= counter[i];
 
-    // encrypt and xor the counter
-    for(int i=0; i<len_p; i++)
-    {
-      inc_ctr(ctr);
-      aes128e(enc_ctr, ctr, key);
-      xor_128( &P[i*BLK_LEN], enc_ctr, &output[i*BLK_LEN]);
-    }
+    // encrypt and xor the counter blocks following the ICB
+    inc_ctr(ctr);
+    aes128e_ctr32(kctxt, output, P, ctr, len_p);
   }
-  log_func_exit();
 }
 
 //------------------------------------------------------------------
 void inc_ctr(unsigned char *ctr)
 {
-  log_func_enter();
   int carry_bit=1;
   for(int i=15;i>=12; i--)
   {
@@ -189,7 +875,6 @@ void inc_ctr(unsigned char *ctr)
       }
     }   
   }
-  log_func_exit();
 }
 
 //------------------------------------------------------------------
@@ -198,7 +883,6 @@ void ghash_128(const unsigned char *H,
                const unsigned int nblocks,
                unsigned char *out)
 {
-  log_func_enter();
   unsigned char Y[BLK_LEN];
   unsigned char xor[BLK_LEN];
 
@@ -211,7 +895,6 @@ void ghash_128(const unsigned char *H,
   }
 
   memcpy(out, Y, BLK_LEN);
-  log_func_exit();
 }
 
 //------------------------------------------------------------------
@@ -267,8 +950,6 @@ void xor_128(const unsigned char *X,
              const unsigned char *Y, 
              unsigned char *out)
 {
-  log_func_enter();
   for(int i=0;i<BLK_LEN;i++)
     out[i]=X[i]^Y[i];
-  log_func_exit();
 }
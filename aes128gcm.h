@@ -5,6 +5,16 @@
 // AUTHOR: Suhas Thejaswi
 // DATE: 12-nov-2014
 // MODIFIED: 12-nov-2014 //gmul initial version completed and tested
+//           17-oct-2026 //gctr under expanded key context
+//           17-oct-2026 //gcm key context, table driven GHASH
+//           17-oct-2026 //carry-less multiply GHASH
+//           17-oct-2026 //streaming init/update/final interface
+//           17-oct-2026 //decryption and constant time tag check
+//           17-oct-2026 //AVX-512 VPCLMULQDQ GHASH
+//           17-oct-2026 //GMAC
+//           17-oct-2026 //bulk key setup
+//           17-oct-2026 //constant time GHASH backend
+//           17-oct-2026 //key setup reports a missing GHASH table
 // DESCRIPTION:
 //  This file is the header file of aes128gcm implementation
 //-------------------------------------------------------------------
@@ -15,6 +25,52 @@
 #include <string.h>
 #include "aes128e.h"
 
+//GHASH backends, all give identical results
+enum
+{
+  GHASH_REF=0, //bit serial gmul_128, no table
+  GHASH_TAB4, //Shoup 4-bit table, 256 bytes per key
+  GHASH_TAB8, //8-bit table, 4 KB per key
+  GHASH_CLMUL, //PCLMULQDQ with H^1..H^8, needs CPU support
+  GHASH_VCLMUL, //AVX-512 VPCLMULQDQ with H^1..H^16, needs CPU support
+  GHASH_CT //constant time integer multiplies with H^1..H^4, 192 bytes
+};
+
+//definition of the GCM key context structure
+typedef struct
+{
+  key_ctxt kctxt;//expanded AES key
+  unsigned char H[16];//hash subkey E(K, 0^128)
+  int ghash;//GHASH backend used by gcm_ghash
+  void *htab;//per key GHASH table, owned by the context
+}gcm_ctxt;
+
+//decryption modes of aes128gcm_decrypt
+enum
+{
+  GCM_VERIFY_FIRST=0, //GHASH pass first, no AES on forged payloads
+  GCM_FUSED //single pass decrypt and hash, for trusted links
+};
+
+//largest plaintext of one message in bytes, 2^39-256 bits
+#define GCM_MAX_PLAINTEXT ((1ULL << 36) - 32)
+
+//definition of the streaming state of one message. it only refers
+//to the key context, which must outlive it
+typedef struct
+{
+  const gcm_ctxt *gctxt;//key context
+  unsigned char J0[16];//pre-counter block
+  unsigned char ctr[16];//next unused counter block
+  unsigned char Y[16];//running GHASH accumulator
+  unsigned char buf[16];//partial AAD or ciphertext block
+  unsigned char ks[16];//keystream of the partial data block
+  unsigned long long len_ad;//AAD bytes so far
+  unsigned long long len_p;//plaintext bytes so far
+  unsigned int buf_len;//bytes held in buf
+  int in_data;//set once the first data byte was processed
+}gcm_stream;
+
 void aes128gcm( unsigned char *ciphertext, 
                 unsigned char *tag, 
                 const unsigned char *k, 
@@ -26,7 +82,198 @@ void aes128gcm( unsigned char *ciphertext,
                 );
 //------------------------------------------------------------------
 // DESCRIPTION:
-//  implementation of aes128 Gllois counter mode function
+//  implementation of aes128 Gllois counter mode function. len_p and
+//  len_ad are in 16-byte blocks. ciphertext and tag are zeroed if the
+//  key setup fails
+//------------------------------------------------------------------
+
+int gcm_init_key(gcm_ctxt *gctxt, const unsigned char *k);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  expands the key, derives H and builds the table of the default
+//  GHASH backend, or of GHASH_CT if that table cannot be allocated.
+//  returns 0 on success, -1 if no table could be built; the context
+//  must not be used then. release with gcm_clear_key() either way
+//------------------------------------------------------------------
+
+int gcm_init_keys(gcm_ctxt *const *gctxts, const unsigned char *const *keys,
+                  unsigned int n);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  gcm_init_key() of n keys for rekeys of many sessions at once.
+//  the key expansions, the derivations of H and the H power tables
+//  of several keys are interleaved. returns 0, or -1 if a context got
+//  no GHASH table, see gcm_init_key(). every context is released
+//  with gcm_clear_key()
+//------------------------------------------------------------------
+
+int gcm_set_ghash(gcm_ctxt *gctxt, int backend);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  selects the GHASH backend and (re)builds its per key table.
+//  returns 0 on success, -1 if the backend is unknown, not supported
+//  by the host or its table cannot be allocated; the previous backend
+//  stays in use in that case
+//------------------------------------------------------------------
+
+int gcm_default_ghash(void);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  returns the GHASH backend gcm_init_key() selects on this host
+//------------------------------------------------------------------
+
+void gcm_ghash(const gcm_ctxt *gctxt, unsigned char *Y,
+               const unsigned char *X, unsigned long nblocks);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  GHASH update with the selected backend, for every 16-byte block
+//  of X computes Y=(Y^X[i])*H. Y holds the running hash
+//------------------------------------------------------------------
+
+void gcm_clear_key(gcm_ctxt *gctxt);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  wipes the key material and frees the GHASH table
+//------------------------------------------------------------------
+
+size_t gcm_key_footprint(const gcm_ctxt *gctxt);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  bytes of memory held by the key context, the structure and its
+//  GHASH table
+//------------------------------------------------------------------
+
+void gcm_init(gcm_stream *st, const gcm_ctxt *gctxt,
+              const unsigned char *IV);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  starts a message under the key context with the 12-byte IV
+//------------------------------------------------------------------
+
+int gcm_update_aad(gcm_stream *st, const unsigned char *add_data,
+                   unsigned long len_ad);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  feeds len_ad bytes of associated data, any chunk size. all AAD
+//  has to come before the first gcm_update(). returns 0 on success,
+//  -1 if data was already processed
+//------------------------------------------------------------------
+
+int gcm_update(gcm_stream *st, unsigned char *ciphertext,
+               const unsigned char *plaintext, unsigned long len_p);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  encrypts len_p bytes, any chunk size, and writes the same number
+//  of ciphertext bytes. ciphertext may equal plaintext. returns 0 on
+//  success, -1 if the message would exceed GCM_MAX_PLAINTEXT
+//------------------------------------------------------------------
+
+int gcm_update_decrypt(gcm_stream *st, unsigned char *plaintext,
+                       const unsigned char *ciphertext, unsigned long len_c);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  decrypting counterpart of gcm_update(). the plaintext is released
+//  before the tag is checked, so it must not be acted upon until
+//  gcm_final_verify() succeeded
+//------------------------------------------------------------------
+
+void gcm_final(gcm_stream *st, unsigned char *tag);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  completes the GHASH with the length block, writes the 16-byte tag
+//  and wipes the stream state
+//------------------------------------------------------------------
+
+int gcm_final_verify(gcm_stream *st, const unsigned char *tag);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  completes a decryption and compares the 16-byte tag in constant
+//  time. returns 0 if it matches, -1 otherwise. wipes the state
+//------------------------------------------------------------------
+
+int gcm_tag_equal(const unsigned char *a, const unsigned char *b,
+                  unsigned long len);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  constant time comparison, returns 1 if the len bytes at a and b
+//  are equal and 0 otherwise
+//------------------------------------------------------------------
+
+int aes128gcm_encrypt( const gcm_ctxt *gctxt,
+                       unsigned char *ciphertext,
+                       unsigned char *tag,
+                       const unsigned char *IV,
+                       const unsigned char *plaintext,
+                       const unsigned long len_p,
+                       const unsigned char *add_data,
+                       const unsigned long len_ad
+                       );
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  one shot encryption under a key context. unlike aes128gcm() the
+//  lengths are in bytes and need not be block multiples. returns 0
+//  on success, -1 if len_p exceeds GCM_MAX_PLAINTEXT
+//------------------------------------------------------------------
+
+int aes128gcm_decrypt( const gcm_ctxt *gctxt,
+                       unsigned char *plaintext,
+                       const unsigned char *tag,
+                       const unsigned char *IV,
+                       const unsigned char *ciphertext,
+                       const unsigned long len_c,
+                       const unsigned char *add_data,
+                       const unsigned long len_ad,
+                       int mode
+                       );
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  one shot authenticated decryption under a key context, lengths in
+//  bytes. GCM_VERIFY_FIRST checks the tag with a GHASH pass and only
+//  then decrypts, a forgery costs no AES work on the payload and
+//  leaves plaintext untouched. GCM_FUSED decrypts and hashes in one
+//  pass and wipes the plaintext if the tag does not match. returns 0
+//  if the message is authentic, -1 otherwise
+//------------------------------------------------------------------
+
+int aes128gmac(const gcm_ctxt *gctxt, unsigned char *tag,
+               const unsigned char *IV, const unsigned char *data,
+               unsigned long len);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  GMAC, authentication without encryption: the GCM tag of an empty
+//  plaintext with data as the associated data, any length in bytes.
+//  only GHASH runs over data, no AES. returns 0
+//------------------------------------------------------------------
+
+int aes128gmac_verify(const gcm_ctxt *gctxt, const unsigned char *tag,
+                      const unsigned char *IV, const unsigned char *data,
+                      unsigned long len);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  computes the GMAC of data and compares it with the 16-byte tag in
+//  constant time. returns 0 if it matches, -1 otherwise
+//------------------------------------------------------------------
+
+void gmac_init(gcm_stream *st, const gcm_ctxt *gctxt,
+               const unsigned char *IV);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  starts a streaming GMAC under the key context with the 12-byte IV
+//------------------------------------------------------------------
+
+void gmac_update(gcm_stream *st, const unsigned char *data,
+                 unsigned long len);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  feeds len bytes of authenticated data, any chunk size
+//------------------------------------------------------------------
+
+void gmac_final(gcm_stream *st, unsigned char *tag);
+int gmac_final_verify(gcm_stream *st, const unsigned char *tag);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  write the 16-byte tag, or compare it in constant time returning 0
+//  if it matches and -1 otherwise, and wipe the state
 //------------------------------------------------------------------
 
 void gmul_128( const unsigned char *X,
@@ -62,6 +309,19 @@ void gctr( const unsigned char *P, //plain text
 //  page number 21
 //------------------------------------------------------------------
 
+void gctr_key( const unsigned char *P, //plain text
+               const key_ctxt *kctxt, //expanded key
+               const unsigned char *counter, //ICB
+               const unsigned long len_p, //length of plain text
+               unsigned char *output //output
+               );
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  same as gctr() but under an already expanded key. the counter
+//  blocks are encrypted by aes128e_ctr32() which keeps several of
+//  them in flight
+//------------------------------------------------------------------
+
 
 void ghash_128( const unsigned char *H, 
                 const unsigned char *X, 
@@ -0,0 +1,281 @@
+//-------------------------------------------------------------------
+// FILE: aes128gcm_batch.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  multi-buffer GCM. jobs are processed in windows; within a window
+//  the E(K,J0) blocks of all jobs, and the payload blocks of bitsliced
+//  keys, go through aes128e_blocks_multi(), other payloads through
+//  aes128e_ctr32() per job. a small job is hashed by one GHASH call
+//  over a contiguous copy of its padded input; GHASH is not interleaved
+//  across jobs, since lanes reduce once per block while one call per
+//  job reduces once per group of blocks
+//-------------------------------------------------------------------
+
+#include <string.h>
+
+#include "aes128gcm_batch.h"
+#include "aes128gcm_impl.h"
+#include "ghash_impl.h"
+
+#define BLK_LEN 16
+//jobs handled together
+#define WINDOW 64
+//AES blocks handed to aes128e_blocks_multi() at once
+#define CHUNK 64
+//GHASH input of a job hashed from one contiguous copy, in bytes
+#define GHASH_BUF 1024
+
+//------------------------------------------------------------------
+//appends len bytes at p zero padded to a block multiple, returns the
+//blocks written
+static unsigned long put_padded(unsigned char *dst, const unsigned char *p,
+                                unsigned long len)
+{
+  unsigned long n=len%BLK_LEN;
+
+  //p may be NULL when len is 0
+  if(len)
+    memcpy(dst, p, len);
+  if(n)
+    memset(&dst[len], 0, BLK_LEN-n);
+  return (len+BLK_LEN-1)/BLK_LEN;
+}
+
+//------------------------------------------------------------------
+//GHASH of every job of the window over ct[j] into S[j]. the padded
+//AAD, ciphertext and length block of a small job are laid out in one
+//buffer and hashed by a single gcm_ghash() call, so the backend
+//reduces once per group of blocks instead of once per block; larger
+//jobs hash their parts in place
+static void batch_ghash(gcm_job *jobs, unsigned int njobs,
+                        const unsigned char *const *ct,
+                        unsigned char (*S)[BLK_LEN])
+{
+  unsigned char buf[GHASH_BUF+BLK_LEN];
+
+  for(unsigned int j=0; j<njobs; j++)
+  {
+    gcm_job *job=&jobs[j];
+    unsigned long long bits_a=8ULL*job->len_ad, bits_c=8ULL*job->len;
+    unsigned char len_blk[BLK_LEN];
+    unsigned long n;
+
+    if(job->status)
+      continue;
+    for(int i=7; i>=0; i--, bits_a>>=8, bits_c>>=8)
+    {
+      len_blk[i]=(unsigned char)bits_a;
+      len_blk[8+i]=(unsigned char)bits_c;
+    }
+    memset(S[j], 0, BLK_LEN);
+    if(job->len_ad+job->len+2*BLK_LEN<=GHASH_BUF)
+    {
+      n=put_padded(buf, job->add_data, job->len_ad);
+      n+=put_padded(&buf[BLK_LEN*n], ct[j], job->len);
+      memcpy(&buf[BLK_LEN*n], len_blk, BLK_LEN);
+      gcm_ghash(job->gctxt, S[j], buf, n+1);
+      continue;
+    }
+    gcm_ghash(job->gctxt, S[j], job->add_data, job->len_ad/BLK_LEN);
+    if(job->len_ad%BLK_LEN)
+    {
+      put_padded(buf, &job->add_data[job->len_ad-job->len_ad%BLK_LEN],
+                 job->len_ad%BLK_LEN);
+      gcm_ghash(job->gctxt, S[j], buf, 1);
+    }
+    gcm_ghash(job->gctxt, S[j], ct[j], job->len/BLK_LEN);
+    if(job->len%BLK_LEN)
+    {
+      put_padded(buf, &ct[j][job->len-job->len%BLK_LEN], job->len%BLK_LEN);
+      gcm_ghash(job->gctxt, S[j], buf, 1);
+    }
+    gcm_ghash(job->gctxt, S[j], len_blk, 1);
+  }
+}
+
+//definition of a chunk of AES blocks collected from several jobs
+typedef struct
+{
+  const key_ctxt *keys[CHUNK];//key of every block
+  unsigned char blk[BLK_LEN*CHUNK];//counter blocks
+  unsigned char ks[BLK_LEN*CHUNK];//their encryption
+  gcm_job *job[CHUNK];//owning job
+  unsigned char *ej0[CHUNK];//destination of an E(K,J0) block or NULL
+  unsigned long off[CHUNK];//payload offset of a counter block
+  unsigned int n;//blocks collected
+}ctr_chunk;
+
+//------------------------------------------------------------------
+static void chunk_flush(ctr_chunk *ch)
+{
+  aes128e_blocks_multi(ch->keys, ch->ks, ch->blk, ch->n);
+  for(unsigned int i=0; i<ch->n; i++)
+  {
+    gcm_job *job=ch->job[i];
+    const unsigned char *ks=&ch->ks[BLK_LEN*i];
+    unsigned long off=ch->off[i], len;
+
+    if(ch->ej0[i])
+    {
+      memcpy(ch->ej0[i], ks, BLK_LEN);
+      continue;
+    }
+    len= (job->len-off < BLK_LEN) ? job->len-off : BLK_LEN;
+    if(len==BLK_LEN)
+      xor_128(&job->in[off], ks, &job->out[off]);
+    else
+      for(unsigned long k=0; k<len; k++)
+        job->out[off+k]= job->in[off+k] ^ ks[k];
+  }
+  ch->n=0;
+}
+
+//------------------------------------------------------------------
+//payload of one job through aes128e_ctr32(), counter J0+1 onwards
+static void job_ctr(gcm_job *job)
+{
+  const key_ctxt *k=&job->gctxt->kctxt;
+  unsigned long full=job->len/BLK_LEN, rem=job->len%BLK_LEN;
+  unsigned char ctr[BLK_LEN], ks[BLK_LEN];
+
+  memcpy(ctr, job->IV, 12);
+  ctr[12]=ctr[13]=ctr[14]=0;
+  ctr[15]=2;
+  aes128e_ctr32(k, job->out, job->in, ctr, full);
+  if(rem)
+  {
+    memset(ks, 0, BLK_LEN);
+    aes128e_ctr32(k, ks, ks, ctr, 1);
+    for(unsigned long i=0; i<rem; i++)
+      job->out[BLK_LEN*full+i]= job->in[BLK_LEN*full+i] ^ ks[i];
+    aes128e_wipe(ks, BLK_LEN);
+  }
+}
+
+//parts of the counter mode done by batch_ctr
+#define CTR_J0 1 //E(K,J0) to ej0
+#define CTR_DATA 2 //payload counter blocks to out
+
+//------------------------------------------------------------------
+//counter mode of all jobs of the window that have not failed
+static void batch_ctr(gcm_job *jobs, unsigned int njobs,
+                      unsigned char (*ej0)[BLK_LEN], int parts)
+{
+  ctr_chunk ch;
+
+  ch.n=0;
+  for(unsigned int j=0; j<njobs; j++)
+  {
+    const key_ctxt *k=&jobs[j].gctxt->kctxt;
+    unsigned long last=0;
+
+    if(jobs[j].status)
+      continue;
+    //only the bitsliced backend gains from packing the payload of
+    //several jobs into one pass, the others pipeline one job best
+    if(parts & CTR_DATA)
+    {
+      if(k->backend==AES128E_BITSLICE)
+        last=(jobs[j].len+BLK_LEN-1)/BLK_LEN;
+      else
+        job_ctr(&jobs[j]);
+    }
+    //block b uses counter J0+b, block 0 being J0 itself
+    for(unsigned long b= (parts & CTR_J0) ? 0 : 1; b<=last; b++)
+    {
+      unsigned char *p=&ch.blk[BLK_LEN*ch.n];
+      uint32_t c=(uint32_t)(b+1);
+
+      memcpy(p, jobs[j].IV, 12);
+      p[12]=(unsigned char)(c >> 24);
+      p[13]=(unsigned char)(c >> 16);
+      p[14]=(unsigned char)(c >> 8);
+      p[15]=(unsigned char)c;
+      ch.keys[ch.n]=k;
+      ch.job[ch.n]=&jobs[j];
+      ch.ej0[ch.n]= b ? NULL : ej0[j];
+      ch.off[ch.n]= b ? BLK_LEN*(b-1) : 0;
+      if(++ch.n==CHUNK)
+        chunk_flush(&ch);
+    }
+  }
+  if(ch.n)
+    chunk_flush(&ch);
+  aes128e_wipe(ch.ks, sizeof(ch.ks));
+}
+
+//------------------------------------------------------------------
+int aes128gcm_encrypt_batch(gcm_job *jobs, unsigned int njobs)
+{
+  const unsigned char *ct[WINDOW];
+  unsigned char ej0[WINDOW][BLK_LEN];
+  unsigned char S[WINDOW][BLK_LEN];
+  int failed=0;
+
+  for(; njobs; )
+  {
+    unsigned int n= (njobs < WINDOW) ? njobs : WINDOW;
+
+    for(unsigned int j=0; j<n; j++)
+    {
+      jobs[j].status= (jobs[j].len > GCM_MAX_PLAINTEXT) ? -1 : 0;
+      failed+= jobs[j].status ? 1 : 0;
+      ct[j]=jobs[j].out;
+    }
+    batch_ctr(jobs, n, ej0, CTR_J0|CTR_DATA);
+    batch_ghash(jobs, n, ct, S);
+    for(unsigned int j=0; j<n; j++)
+      if(!jobs[j].status)
+        xor_128(ej0[j], S[j], jobs[j].tag);
+
+    jobs+=n;
+    njobs-=n;
+  }
+  aes128e_wipe(ej0, sizeof(ej0));
+  aes128e_wipe(S, sizeof(S));
+  return failed;
+}
+
+//------------------------------------------------------------------
+int aes128gcm_decrypt_batch(gcm_job *jobs, unsigned int njobs)
+{
+  const unsigned char *ct[WINDOW];
+  unsigned char ej0[WINDOW][BLK_LEN];
+  unsigned char S[WINDOW][BLK_LEN];
+  int failed=0;
+
+  for(; njobs; )
+  {
+    unsigned int n= (njobs < WINDOW) ? njobs : WINDOW;
+
+    for(unsigned int j=0; j<n; j++)
+    {
+      jobs[j].status= (jobs[j].len > GCM_MAX_PLAINTEXT) ? -1 : 0;
+      ct[j]=jobs[j].in;
+    }
+
+    //verify first, only authentic jobs get their payload decrypted
+    batch_ghash(jobs, n, ct, S);
+    batch_ctr(jobs, n, ej0, CTR_J0);
+    for(unsigned int j=0; j<n; j++)
+    {
+      if(jobs[j].status)
+        continue;
+      xor_128(ej0[j], S[j], S[j]);
+      if(!gcm_tag_equal(S[j], jobs[j].tag, BLK_LEN))
+        jobs[j].status=-1;
+    }
+    batch_ctr(jobs, n, ej0, CTR_DATA);
+    for(unsigned int j=0; j<n; j++)
+      failed+= jobs[j].status ? 1 : 0;
+
+    jobs+=n;
+    njobs-=n;
+  }
+  aes128e_wipe(ej0, sizeof(ej0));
+  aes128e_wipe(S, sizeof(S));
+  return failed;
+}
+
+//end of file
@@ -0,0 +1,46 @@
+#ifndef AES128GCM_BATCH_H
+#define AES128GCM_BATCH_H
+//-------------------------------------------------------------------
+// FILE: aes128gcm_batch.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  multi-buffer interface for many small independent messages. the
+//  E(K,J0) blocks of all jobs are encrypted together, with bitsliced
+//  keys their counter blocks too, so the fixed per message latencies
+//  overlap
+//-------------------------------------------------------------------
+
+#include "aes128gcm.h"
+
+//definition of one message of a batch
+typedef struct
+{
+  const gcm_ctxt *gctxt;//key context of the message
+  const unsigned char *IV;//12-byte IV
+  const unsigned char *add_data;//associated data
+  unsigned long len_ad;//bytes of associated data
+  const unsigned char *in;//plaintext or ciphertext
+  unsigned long len;//bytes of in and of out
+  unsigned char *out;//ciphertext or plaintext, may equal in
+  unsigned char tag[16];//written by encryption, checked by decryption
+  int status;//0 on success, -1 on failure
+}gcm_job;
+
+int aes128gcm_encrypt_batch(gcm_job *jobs, unsigned int njobs);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  encrypts every job and writes its tag. a job fails only if its
+//  length exceeds GCM_MAX_PLAINTEXT. returns the number of failed
+//  jobs
+//------------------------------------------------------------------
+
+int aes128gcm_decrypt_batch(gcm_job *jobs, unsigned int njobs);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  verifies the tag of every job first and decrypts only the
+//  authentic ones, the output of a failed job is left untouched.
+//  returns the number of failed jobs
+//------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,484 @@
+//-------------------------------------------------------------------
+// FILE: aes128gcm_bench.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  throughput and latency benchmark of aes128gcm_encrypt(),
+//  aes128gcm_decrypt() and aes128gmac() over message sizes, AAD sizes
+//  and every available AES and GHASH backend. GMAC authenticates len
+//  bytes and runs without further AAD. the batch op encrypts
+//  BATCH_JOBS messages of len bytes under as many keys with one
+//  aes128gcm_encrypt_batch() call, its calls count messages and it
+//  has no latencies. one line of output per point:
+//    aes,ghash,op,len,len_ad,calls,cycles_per_byte,gbps,p50_ns,p99_ns
+//  cycles are TSC reference cycles per message byte and are empty on
+//  hosts without a TSC. p50/p99 per call latencies are only measured
+//  for messages up to LAT_MAX_LEN bytes
+//
+//  usage: aes128gcm_bench [-f csv|json] [-m max_len] [-t min_sec]
+//                         [-l max_call_sec] [-A aes] [-G ghash] [-d] [-g]
+//                         [-b]
+//-------------------------------------------------------------------
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "aes128e.h"
+#include "aes128gcm.h"
+#include "aes128gcm_batch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#else
+#define HAVE_TSC 0
+#endif
+
+#define MAX_LEN (64UL << 20)
+#define LAT_MAX_LEN 4096
+#define LAT_SAMPLES 20000
+//messages of one batch op call
+#define BATCH_JOBS 64
+
+enum {OP_ENC=0, OP_DEC, OP_GMAC, OP_BATCH, NOPS};
+enum {FMT_CSV=0, FMT_JSON};
+
+//definition of a backend name
+typedef struct
+{
+  const char *name;
+  int id;
+}backend_name;
+
+//definition of one measured point
+typedef struct
+{
+  const char *aes;
+  const char *ghash;
+  int op;
+  unsigned long len;
+  unsigned long len_ad;
+  unsigned long long calls;
+  double cpb;//TSC cycles per message byte, <0 without a TSC
+  double gbps;
+  double p50_ns;//<0 when latency is not measured
+  double p99_ns;
+}bench_point;
+
+static const backend_name aes_names[]={
+  {"ref", AES128E_REF}, {"ttable", AES128E_TTABLE},
+  {"aesni", AES128E_AESNI}, {"bitslice", AES128E_BITSLICE},
+  {"vaes", AES128E_VAES}};
+static const backend_name ghash_names[]={
+  {"ref", GHASH_REF}, {"tab4", GHASH_TAB4},
+  {"tab8", GHASH_TAB8}, {"clmul", GHASH_CLMUL}, {"vclmul", GHASH_VCLMUL},
+  {"ct", GHASH_CT}};
+static const unsigned long aad_lens[]={0, 13, 1024};
+
+static gcm_ctxt batch_ctxt[BATCH_JOBS];//keys of the batch op
+static gcm_job batch_jobs[BATCH_JOBS];
+static double tsc_ns;//nanoseconds per TSC cycle
+static int format=FMT_CSV;
+static unsigned long npoints;
+
+//------------------------------------------------------------------
+static double now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec+1e-9*(double)ts.tv_nsec;
+}
+
+//------------------------------------------------------------------
+static uint64_t cycles(void)
+{
+#if HAVE_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+//------------------------------------------------------------------
+//TSC period against the monotonic clock over ~50 ms
+static double tsc_calibrate(void)
+{
+  double t0=now(), t1;
+  uint64_t c0=cycles(), c1;
+
+  do
+    t1=now();
+  while(t1-t0<0.05);
+  c1=cycles();
+  return (c1>c0) ? 1e9*(t1-t0)/(double)(c1-c0) : 0.0;
+}
+
+//------------------------------------------------------------------
+static int cmp_double(const void *a, const void *b)
+{
+  double x=*(const double *)a, y=*(const double *)b;
+
+  return (x>y)-(x<y);
+}
+
+//------------------------------------------------------------------
+//BATCH_JOBS messages sharing the buffers, each under its own key
+static int batch_call(unsigned char *out, const unsigned char *IV,
+                      const unsigned char *in, unsigned long len,
+                      const unsigned char *aad, unsigned long len_ad)
+{
+  for(int j=0; j<BATCH_JOBS; j++)
+  {
+    gcm_job *job=&batch_jobs[j];
+
+    job->gctxt=&batch_ctxt[j];
+    job->IV=IV;
+    job->add_data=aad;
+    job->len_ad=len_ad;
+    job->in=in;
+    job->len=len;
+    job->out=out;
+  }
+  return aes128gcm_encrypt_batch(batch_jobs, BATCH_JOBS) ? -1 : 0;
+}
+
+//------------------------------------------------------------------
+static int gcm_call(const gcm_ctxt *g, int op, unsigned char *out,
+                    unsigned char *tag, const unsigned char *IV,
+                    const unsigned char *in, unsigned long len,
+                    const unsigned char *aad, unsigned long len_ad)
+{
+  if(op==OP_ENC)
+    return aes128gcm_encrypt(g, out, tag, IV, in, len, aad, len_ad);
+  if(op==OP_GMAC)
+    return aes128gmac(g, tag, IV, in, len);
+  if(op==OP_BATCH)
+    return batch_call(out, IV, in, len, aad, len_ad);
+  return aes128gcm_decrypt(g, out, tag, IV, in, len, aad, len_ad,
+                           GCM_FUSED);
+}
+
+//------------------------------------------------------------------
+//runs op for at least min_time seconds. decryption runs over the
+//ciphertext of buf and writes the plaintext back to buf
+static int bench_run(const gcm_ctxt *g, int op, unsigned char *buf,
+                     unsigned char *out, const unsigned char *aad,
+                     unsigned long len, unsigned long len_ad,
+                     double min_time, double *samples, bench_point *pt)
+{
+  static const unsigned char IV[12]={0};
+  unsigned char tag[16];
+  unsigned char *src=buf, *dst=out;
+  unsigned long batch=1, msgs= (op==OP_BATCH) ? BATCH_JOBS : 1;
+  unsigned long long calls=0;
+  double t0, el;
+  uint64_t c0;
+
+  if(op==OP_DEC)
+  {
+    if(aes128gcm_encrypt(g, out, tag, IV, buf, len, aad, len_ad))
+      return -1;
+    src=out;
+    dst=buf;
+  }
+  //warm up the caches and the branch predictors
+  if(gcm_call(g, op, dst, tag, IV, src, len, aad, len_ad))
+    return -1;
+
+  t0=now();
+  c0=cycles();
+  do
+  {
+    for(unsigned long i=0; i<batch; i++)
+      gcm_call(g, op, dst, tag, IV, src, len, aad, len_ad);
+    calls+=batch*msgs;
+    el=now()-t0;
+    //grow the calls between two clock reads while they are cheap
+    if(el<min_time/16)
+      batch*=2;
+  }while(el<min_time);
+
+  pt->calls=calls;
+  pt->gbps=(double)len*(double)calls/el*1e-9;
+  pt->cpb= (HAVE_TSC && len) ?
+           (double)(cycles()-c0)/((double)len*(double)calls) : -1.0;
+  pt->p50_ns=pt->p99_ns=-1.0;
+
+  if(len<=LAT_MAX_LEN && op!=OP_BATCH)
+  {
+    unsigned long n=0;
+
+    t0=now();
+    do
+    {
+      if(HAVE_TSC && tsc_ns>0.0)
+      {
+        uint64_t c=cycles();
+
+        gcm_call(g, op, dst, tag, IV, src, len, aad, len_ad);
+        samples[n]=tsc_ns*(double)(cycles()-c);
+      }
+      else
+      {
+        double t=now();
+
+        gcm_call(g, op, dst, tag, IV, src, len, aad, len_ad);
+        samples[n]=1e9*(now()-t);
+      }
+      n++;
+    }while(n<LAT_SAMPLES && now()-t0<min_time);
+
+    qsort(samples, n, sizeof(double), cmp_double);
+    pt->p50_ns=samples[n/2];
+    pt->p99_ns=samples[(n*99)/100];
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------
+static void print_num(double v, const char *none)
+{
+  if(v<0.0)
+    printf("%s", none);
+  else
+    printf("%.3f", v);
+}
+
+//------------------------------------------------------------------
+static void print_point(const bench_point *pt)
+{
+  static const char *op_names[NOPS]={"encrypt", "decrypt", "gmac",
+                                          "batch"};
+  const char *op=op_names[pt->op];
+
+  if(format==FMT_CSV)
+  {
+    printf("%s,%s,%s,%lu,%lu,%llu,", pt->aes, pt->ghash, op, pt->len,
+           pt->len_ad, pt->calls);
+    print_num(pt->cpb, "");
+    printf(",%.4f,", pt->gbps);
+    print_num(pt->p50_ns, "");
+    printf(",");
+    print_num(pt->p99_ns, "");
+    printf("\n");
+  }
+  else
+  {
+    printf("%s  {\"aes\": \"%s\", \"ghash\": \"%s\", \"op\": \"%s\", "
+           "\"len\": %lu, \"len_ad\": %lu, \"calls\": %llu, "
+           "\"cycles_per_byte\": ", npoints ? ",\n" : "", pt->aes,
+           pt->ghash, op, pt->len, pt->len_ad, pt->calls);
+    print_num(pt->cpb, "null");
+    printf(", \"gbps\": %.4f, \"p50_ns\": ", pt->gbps);
+    print_num(pt->p50_ns, "null");
+    printf(", \"p99_ns\": ");
+    print_num(pt->p99_ns, "null");
+    printf("}");
+  }
+  npoints++;
+  fflush(stdout);
+}
+
+//------------------------------------------------------------------
+static int lookup(const backend_name *names, int n, const char *name)
+{
+  for(int i=0; i<n; i++)
+    if(!strcmp(names[i].name, name))
+      return i;
+  return -1;
+}
+
+//------------------------------------------------------------------
+static void usage(const char *prog)
+{
+  fprintf(stderr,
+          "usage: %s [-f csv|json] [-m max_len] [-t min_sec] "
+          "[-l max_call_sec] [-A aes] [-G ghash] [-d] [-g] [-b]\n"
+          "  -d: decryption too, -g: GMAC too, -b: batch encryption too\n"
+          "  aes: ref ttable aesni bitslice vaes,\n"
+          "  ghash: ref tab4 tab8 clmul vclmul ct\n",
+          prog);
+}
+
+//------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+  const unsigned char key[16]={0x98,0xff,0xf6,0x7e,0x64,0xe4,0x6b,0xe5,
+                               0xee,0x2e,0x05,0xcc,0x9a,0xf6,0xd0,0x12};
+  int naes=sizeof(aes_names)/sizeof(aes_names[0]);
+  int nghash=sizeof(ghash_names)/sizeof(ghash_names[0]);
+  int naad=sizeof(aad_lens)/sizeof(aad_lens[0]);
+  int only_aes=-1, only_ghash=-1, opt;
+  unsigned int ops=1U << OP_ENC;
+  unsigned long max_len=MAX_LEN, max_aad=0;
+  double min_time=0.05, max_call=1.0;
+  unsigned char *buf, *out, *aad;
+  double *samples;
+  gcm_ctxt g;
+
+  while((opt=getopt(argc, argv, "f:m:t:l:A:G:dgbh"))!=-1)
+  {
+    switch(opt)
+    {
+      case 'f':
+        if(!strcmp(optarg, "csv"))
+          format=FMT_CSV;
+        else if(!strcmp(optarg, "json"))
+          format=FMT_JSON;
+        else
+          return usage(argv[0]), 1;
+        break;
+      case 'm':
+        max_len=strtoul(optarg, NULL, 0);
+        if(max_len<16)
+          max_len=16;
+        break;
+      case 't':
+        min_time=atof(optarg);
+        break;
+      case 'l':
+        max_call=atof(optarg);
+        break;
+      case 'A':
+        if((only_aes=lookup(aes_names, naes, optarg))<0)
+          return usage(argv[0]), 1;
+        break;
+      case 'G':
+        if((only_ghash=lookup(ghash_names, nghash, optarg))<0)
+          return usage(argv[0]), 1;
+        break;
+      case 'd':
+        ops|=1U << OP_DEC;
+        break;
+      case 'g':
+        ops|=1U << OP_GMAC;
+        break;
+      case 'b':
+        ops|=1U << OP_BATCH;
+        break;
+      default:
+        usage(argv[0]);
+        return opt!='h';
+    }
+  }
+
+  for(int i=0; i<naad; i++)
+    if(aad_lens[i]>max_aad)
+      max_aad=aad_lens[i];
+  buf=malloc(max_len);
+  out=malloc(max_len);
+  aad=malloc(max_aad);
+  samples=malloc(LAT_SAMPLES*sizeof(double));
+  if(!buf || !out || !aad || !samples)
+  {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+  for(unsigned long i=0; i<max_len; i++)
+    buf[i]=(unsigned char)(i*131+7);
+  memset(aad, 0xa5, max_aad);
+  tsc_ns= HAVE_TSC ? tsc_calibrate() : 0.0;
+  if(tsc_ns>0.0)
+    fprintf(stderr, "TSC %.3f GHz\n", 1.0/tsc_ns);
+
+  if(format==FMT_CSV)
+    printf("aes,ghash,op,len,len_ad,calls,cycles_per_byte,gbps,"
+           "p50_ns,p99_ns\n");
+  else
+    printf("[\n");
+
+  if(gcm_init_key(&g, key))
+  {
+    fprintf(stderr, "out of memory\n");
+    gcm_clear_key(&g);
+    return 1;
+  }
+  for(int a=0; a<naes; a++)
+  {
+    if((only_aes>=0 && a!=only_aes) ||
+       aes128e_set_backend(&g.kctxt, aes_names[a].id))
+      continue;
+    for(int h=0; h<nghash; h++)
+    {
+      int nbatch=0;
+
+      if((only_ghash>=0 && h!=only_ghash) ||
+         gcm_set_ghash(&g, ghash_names[h].id))
+        continue;
+      //keys of the batch op, on the same backends
+      for(; (ops & (1U << OP_BATCH)) && nbatch<BATCH_JOBS; nbatch++)
+      {
+        unsigned char k[16];
+
+        memcpy(k, key, 16);
+        k[0]^=(unsigned char)nbatch;
+        if(gcm_init_key(&batch_ctxt[nbatch], k) ||
+           aes128e_set_backend(&batch_ctxt[nbatch].kctxt, aes_names[a].id) ||
+           gcm_set_ghash(&batch_ctxt[nbatch], ghash_names[h].id))
+        {
+          gcm_clear_key(&batch_ctxt[nbatch]);
+          break;
+        }
+      }
+      for(int op=0; op<NOPS; op++)
+        for(int d=0; d<naad; d++)
+        {
+          double per_call=0.0;
+          unsigned long prev=0;
+
+          if(!(ops & (1U << op)) || (op==OP_GMAC && aad_lens[d]) ||
+             (op==OP_BATCH && nbatch<BATCH_JOBS))
+            continue;
+
+          for(unsigned long len=16; len<=max_len; len*=4)
+          {
+            bench_point pt;
+
+            //the sizes grow by 4x, skip the rest of the sweep when
+            //the next call would take longer than max_call
+            if(prev && per_call*(double)(len+aad_lens[d])/
+               (double)(prev+aad_lens[d])>max_call)
+            {
+              fprintf(stderr, "%s/%s: skipping len>=%lu len_ad=%lu\n",
+                      aes_names[a].name, ghash_names[h].name, len,
+                      aad_lens[d]);
+              break;
+            }
+            pt.aes=aes_names[a].name;
+            pt.ghash=ghash_names[h].name;
+            pt.op=op;
+            pt.len=len;
+            pt.len_ad=aad_lens[d];
+            if(bench_run(&g, op, buf, out, aad, len, aad_lens[d],
+                         min_time, samples, &pt))
+            {
+              fprintf(stderr, "%s/%s: call failed at len=%lu\n",
+                      aes_names[a].name, ghash_names[h].name, len);
+              break;
+            }
+            print_point(&pt);
+            per_call= (pt.gbps>0.0) ? (double)len*1e-9/pt.gbps : 0.0;
+            prev=len;
+          }
+        }
+      while(nbatch)
+        gcm_clear_key(&batch_ctxt[--nbatch]);
+    }
+  }
+  if(format==FMT_JSON)
+    printf("\n]\n");
+
+  gcm_clear_key(&g);
+  free(buf);
+  free(out);
+  free(aad);
+  free(samples);
+  return 0;
+}
@@ -0,0 +1,321 @@
+//-------------------------------------------------------------------
+// FILE: aes128gcm_chunk.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  seekable chunked container, see aes128gcm_chunk.h for the layout.
+//  whole file jobs hand every thread a contiguous run of chunks and
+//  use pread()/pwrite() so the threads share the descriptors
+//-------------------------------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "aes128gcm_chunk.h"
+
+#define TAG_LEN 16
+#define AAD_LEN (GCM_CHUNK_HEADER_LEN+8)
+#define MAX_THREADS 256
+#define MAX_LEN (1ULL << 62)
+
+static const unsigned char magic[8]={'A','G','C','M','C','H','K','1'};
+
+//definition of the work of one thread
+typedef struct
+{
+  const gcm_ctxt *gctxt;
+  const gcm_chunk_header *hdr;
+  int in_fd;
+  int out_fd;
+  unsigned long long first;//first chunk
+  unsigned long long end;//one past the last chunk
+  int decrypt;
+  int status;
+}chunk_work;
+
+//------------------------------------------------------------------
+static void put_be(unsigned char *p, unsigned long long v, int n)
+{
+  for(int i=n-1; i>=0; i--, v>>=8)
+    p[i]=(unsigned char)v;
+}
+
+//------------------------------------------------------------------
+static unsigned long long get_be(const unsigned char *p, int n)
+{
+  unsigned long long v=0;
+
+  for(int i=0; i<n; i++)
+    v=(v << 8) | p[i];
+  return v;
+}
+
+//------------------------------------------------------------------
+//pread()/pwrite() until len bytes are done, -1 on error or EOF
+static int full_pread(int fd, unsigned char *buf, size_t len,
+                      unsigned long long off)
+{
+  while(len)
+  {
+    ssize_t n=pread(fd, buf, len, (off_t)off);
+
+    if(n<0 && errno==EINTR)
+      continue;
+    if(n<=0)
+      return -1;
+    buf+=n;
+    len-=(size_t)n;
+    off+=(unsigned long long)n;
+  }
+  return 0;
+}
+
+static int full_pwrite(int fd, const unsigned char *buf, size_t len,
+                       unsigned long long off)
+{
+  while(len)
+  {
+    ssize_t n=pwrite(fd, buf, len, (off_t)off);
+
+    if(n<0 && errno==EINTR)
+      continue;
+    if(n<=0)
+      return -1;
+    buf+=n;
+    len-=(size_t)n;
+    off+=(unsigned long long)n;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------
+static unsigned long chunk_len(const gcm_chunk_header *hdr,
+                               unsigned long long i)
+{
+  unsigned long long off=i*hdr->chunk_size;
+
+  return (hdr->len-off < hdr->chunk_size) ?
+         (unsigned long)(hdr->len-off) : hdr->chunk_size;
+}
+
+//------------------------------------------------------------------
+static unsigned long long tag_off(unsigned long long i)
+{
+  return GCM_CHUNK_HEADER_LEN+TAG_LEN*i;
+}
+
+static unsigned long long data_off(const gcm_chunk_header *hdr,
+                                   unsigned long long i)
+{
+  return tag_off(hdr->nchunks)+i*hdr->chunk_size;
+}
+
+//------------------------------------------------------------------
+//IV and AAD of chunk i
+static void chunk_params(const gcm_chunk_header *hdr, unsigned long long i,
+                         unsigned char *IV, unsigned char *aad)
+{
+  memcpy(aad, hdr->raw, GCM_CHUNK_HEADER_LEN);
+  put_be(&aad[GCM_CHUNK_HEADER_LEN], i, 8);
+  memcpy(IV, hdr->nonce, 12);
+  for(int k=0; k<8; k++)
+    IV[4+k]^=aad[GCM_CHUNK_HEADER_LEN+k];
+}
+
+//------------------------------------------------------------------
+int aes128gcm_chunk_header_init(gcm_chunk_header *hdr,
+                                unsigned long chunk_size,
+                                unsigned long long len,
+                                const unsigned char *nonce)
+{
+  if(chunk_size<16 || chunk_size>GCM_CHUNK_MAX_SIZE || chunk_size%16 ||
+     len>MAX_LEN)
+    return -1;
+  hdr->chunk_size=chunk_size;
+  hdr->len=len;
+  hdr->nchunks= len ? (len+chunk_size-1)/chunk_size : 1;
+  memcpy(hdr->nonce, nonce, 12);
+
+  memcpy(hdr->raw, magic, 8);
+  put_be(&hdr->raw[8], chunk_size, 4);
+  put_be(&hdr->raw[12], 0, 4);
+  put_be(&hdr->raw[16], len, 8);
+  memcpy(&hdr->raw[24], nonce, 12);
+  put_be(&hdr->raw[36], 0, 4);
+  return 0;
+}
+
+//------------------------------------------------------------------
+int aes128gcm_chunk_read_header(int fd, gcm_chunk_header *hdr)
+{
+  unsigned char raw[GCM_CHUNK_HEADER_LEN];
+
+  if(full_pread(fd, raw, sizeof(raw), 0) || memcmp(raw, magic, 8) ||
+     get_be(&raw[12], 4) || get_be(&raw[36], 4))
+    return -1;
+  if(aes128gcm_chunk_header_init(hdr, (unsigned long)get_be(&raw[8], 4),
+                                 get_be(&raw[16], 8), &raw[24]))
+    return -1;
+  return 0;
+}
+
+//------------------------------------------------------------------
+static void *chunk_worker(void *arg)
+{
+  chunk_work *w=(chunk_work *)arg;
+  const gcm_chunk_header *hdr=w->hdr;
+  unsigned char IV[12], aad[AAD_LEN], tag[TAG_LEN];
+  unsigned char *buf=malloc(hdr->chunk_size);
+
+  w->status= buf ? 0 : -1;
+  for(unsigned long long i=w->first; i<w->end && !w->status; i++)
+  {
+    unsigned long n=chunk_len(hdr, i);
+
+    chunk_params(hdr, i, IV, aad);
+    if(!w->decrypt)
+    {
+      w->status= (full_pread(w->in_fd, buf, n, i*hdr->chunk_size) ||
+                  aes128gcm_encrypt(w->gctxt, buf, tag, IV, buf, n, aad,
+                                    AAD_LEN) ||
+                  full_pwrite(w->out_fd, tag, TAG_LEN, tag_off(i)) ||
+                  full_pwrite(w->out_fd, buf, n, data_off(hdr, i))) ? -1 : 0;
+    }
+    else
+    {
+      w->status= (full_pread(w->in_fd, tag, TAG_LEN, tag_off(i)) ||
+                  full_pread(w->in_fd, buf, n, data_off(hdr, i)) ||
+                  aes128gcm_decrypt(w->gctxt, buf, tag, IV, buf, n, aad,
+                                    AAD_LEN, GCM_FUSED) ||
+                  full_pwrite(w->out_fd, buf, n, i*hdr->chunk_size)) ? -1 : 0;
+    }
+  }
+  if(buf)
+  {
+    aes128e_wipe(buf, hdr->chunk_size);
+    free(buf);
+  }
+  return NULL;
+}
+
+//------------------------------------------------------------------
+//runs all chunks of hdr in contiguous runs over up to nthreads
+static int chunk_run(const gcm_ctxt *gctxt, const gcm_chunk_header *hdr,
+                     int out_fd, int in_fd, unsigned int nthreads,
+                     int decrypt)
+{
+  chunk_work work[MAX_THREADS];
+  pthread_t tid[MAX_THREADS];
+  int started[MAX_THREADS];
+  unsigned int n;
+  int status=0;
+
+  n= nthreads ? nthreads : 1;
+  if(n>MAX_THREADS)
+    n=MAX_THREADS;
+  if(n>hdr->nchunks)
+    n=(unsigned int)hdr->nchunks;
+
+  for(unsigned int i=0; i<n; i++)
+  {
+    work[i].gctxt=gctxt;
+    work[i].hdr=hdr;
+    work[i].in_fd=in_fd;
+    work[i].out_fd=out_fd;
+    //the first nchunks%n runs take one chunk more
+    work[i].first=hdr->nchunks/n*i+(i<hdr->nchunks%n ? i : hdr->nchunks%n);
+    work[i].end=work[i].first+hdr->nchunks/n+(i<hdr->nchunks%n);
+    work[i].decrypt=decrypt;
+  }
+
+  //the calling thread takes the first run, a run whose thread cannot
+  //be created runs inline
+  for(unsigned int i=1; i<n; i++)
+    started[i]= !pthread_create(&tid[i], NULL, chunk_worker, &work[i]);
+  chunk_worker(&work[0]);
+  for(unsigned int i=1; i<n; i++)
+  {
+    if(started[i])
+      pthread_join(tid[i], NULL);
+    else
+      chunk_worker(&work[i]);
+  }
+  for(unsigned int i=0; i<n; i++)
+    status|=work[i].status;
+  return status ? -1 : 0;
+}
+
+//------------------------------------------------------------------
+int aes128gcm_chunk_encrypt_fd(const gcm_ctxt *gctxt, int out_fd,
+                               int in_fd, const gcm_chunk_header *hdr,
+                               unsigned int nthreads)
+{
+  if(full_pwrite(out_fd, hdr->raw, GCM_CHUNK_HEADER_LEN, 0))
+    return -1;
+  return chunk_run(gctxt, hdr, out_fd, in_fd, nthreads, 0);
+}
+
+//------------------------------------------------------------------
+int aes128gcm_chunk_decrypt_fd(const gcm_ctxt *gctxt, int out_fd,
+                               int in_fd, unsigned int nthreads)
+{
+  gcm_chunk_header hdr;
+
+  if(aes128gcm_chunk_read_header(in_fd, &hdr))
+    return -1;
+  return chunk_run(gctxt, &hdr, out_fd, in_fd, nthreads, 1);
+}
+
+//------------------------------------------------------------------
+int aes128gcm_chunk_decrypt_range(const gcm_ctxt *gctxt, int fd,
+                                  const gcm_chunk_header *hdr,
+                                  unsigned char *out,
+                                  unsigned long long off,
+                                  unsigned long len)
+{
+  unsigned char IV[12], aad[AAD_LEN], tag[TAG_LEN];
+  unsigned char *buf;
+  unsigned long long first, last;
+  unsigned long done=0;
+  int status=0;
+
+  if(off>hdr->len || len>hdr->len-off)
+    return -1;
+  if(!len)
+    return 0;
+  if(!(buf=malloc(hdr->chunk_size)))
+    return -1;
+
+  first=off/hdr->chunk_size;
+  last=(off+len-1)/hdr->chunk_size;
+  for(unsigned long long i=first; i<=last && !status; i++)
+  {
+    unsigned long n=chunk_len(hdr, i);
+    unsigned long skip= (i==first) ? (unsigned long)(off%hdr->chunk_size) : 0;
+    unsigned long take= (n-skip < len-done) ? n-skip : len-done;
+
+    chunk_params(hdr, i, IV, aad);
+    status= (full_pread(fd, tag, TAG_LEN, tag_off(i)) ||
+             full_pread(fd, buf, n, data_off(hdr, i)) ||
+             aes128gcm_decrypt(gctxt, buf, tag, IV, buf, n, aad, AAD_LEN,
+                               GCM_VERIFY_FIRST)) ? -1 : 0;
+    if(!status)
+    {
+      memcpy(&out[done], &buf[skip], take);
+      done+=take;
+    }
+  }
+  aes128e_wipe(buf, hdr->chunk_size);
+  free(buf);
+  if(status)
+    aes128e_wipe(out, len);
+  return status;
+}
+
+//end of file
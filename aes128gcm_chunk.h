@@ -0,0 +1,90 @@
+#ifndef AES128GCM_CHUNK_H
+#define AES128GCM_CHUNK_H
+//-------------------------------------------------------------------
+// FILE: aes128gcm_chunk.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  seekable container of fixed size chunks, each one sealed with
+//  aes128gcm_encrypt() under its own IV. layout of a file:
+//    header   GCM_CHUNK_HEADER_LEN bytes
+//      magic "AGCMCHK1", chunk size (u32), flags (u32, zero),
+//      plaintext length (u64), 12-byte nonce, 4 zero bytes
+//    index    16-byte tag of every chunk, chunk order
+//    data     ciphertext, the same length as the plaintext
+//  integers are big endian. chunk i uses the IV nonce^(0^4||i) with i
+//  as a u64 and the AAD header||i, so chunks cannot be moved,
+//  swapped between files or the file truncated. an empty plaintext
+//  still has one (empty) chunk which authenticates the header
+//-------------------------------------------------------------------
+
+#include "aes128gcm.h"
+
+#define GCM_CHUNK_HEADER_LEN 40
+#define GCM_CHUNK_DEFAULT_SIZE (64*1024)
+#define GCM_CHUNK_MAX_SIZE (1UL << 30)
+
+//definition of a parsed container header
+typedef struct
+{
+  unsigned long chunk_size;//bytes of plaintext per chunk
+  unsigned long long len;//bytes of plaintext of the whole file
+  unsigned long long nchunks;
+  unsigned char nonce[12];
+  unsigned char raw[GCM_CHUNK_HEADER_LEN];//header as stored
+}gcm_chunk_header;
+
+int aes128gcm_chunk_header_init(gcm_chunk_header *hdr,
+                                unsigned long chunk_size,
+                                unsigned long long len,
+                                const unsigned char *nonce);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  fills in the header of a new container. the 12-byte nonce must
+//  never repeat under one key, a random value per file does. returns
+//  0 on success, -1 if chunk_size is not a multiple of 16 in
+//  [16, GCM_CHUNK_MAX_SIZE]
+//------------------------------------------------------------------
+
+int aes128gcm_chunk_read_header(int fd, gcm_chunk_header *hdr);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  reads and checks the header at the start of the container fd.
+//  the header is authenticated only when a chunk is decrypted.
+//  returns 0 on success, -1 on a read error or a malformed header
+//------------------------------------------------------------------
+
+int aes128gcm_chunk_encrypt_fd(const gcm_ctxt *gctxt, int out_fd,
+                               int in_fd, const gcm_chunk_header *hdr,
+                               unsigned int nthreads);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  writes the container of the hdr->len bytes at the start of in_fd
+//  to out_fd. the chunks are spread over up to nthreads threads, both
+//  descriptors must be seekable. returns 0 on success, -1 on an I/O
+//  error
+//------------------------------------------------------------------
+
+int aes128gcm_chunk_decrypt_fd(const gcm_ctxt *gctxt, int out_fd,
+                               int in_fd, unsigned int nthreads);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  decrypts the whole container in_fd to out_fd over up to nthreads
+//  threads. only chunks whose tag matches are written, on -1 the
+//  output is incomplete and must be discarded. returns 0 if every
+//  chunk is authentic, -1 otherwise
+//------------------------------------------------------------------
+
+int aes128gcm_chunk_decrypt_range(const gcm_ctxt *gctxt, int fd,
+                                  const gcm_chunk_header *hdr,
+                                  unsigned char *out,
+                                  unsigned long long off,
+                                  unsigned long len);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  decrypts plaintext bytes [off, off+len) of the container fd,
+//  reading and verifying only the chunks the range touches. returns
+//  0 on success, -1 if the range is outside the plaintext, on an I/O
+//  error or if a chunk is not authentic; out is wiped on failure
+//------------------------------------------------------------------
+#endif
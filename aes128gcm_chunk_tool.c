@@ -0,0 +1,178 @@
+//-------------------------------------------------------------------
+// FILE: aes128gcm_chunk_tool.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  command line front end of the chunked container
+//    aes128gcm_chunk enc   -k key [-c chunk_size] [-t threads] in out
+//    aes128gcm_chunk dec   -k key [-t threads] in out
+//    aes128gcm_chunk range -k key -o offset -l length in out
+//  key is 32 hex digits, or @file for 16 raw bytes. out may be - for
+//  the standard output with range. the nonce of a new container is
+//  read from /dev/urandom
+//-------------------------------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "aes128gcm.h"
+#include "aes128gcm_chunk.h"
+
+//------------------------------------------------------------------
+static void usage(const char *prog)
+{
+  fprintf(stderr,
+          "usage: %s enc   -k key [-c chunk_size] [-t threads] in out\n"
+          "       %s dec   -k key [-t threads] in out\n"
+          "       %s range -k key -o offset -l length in out|-\n"
+          "  key: 32 hex digits or @file with 16 raw bytes\n",
+          prog, prog, prog);
+}
+
+//------------------------------------------------------------------
+static int read_all(const char *path, unsigned char *buf, size_t len)
+{
+  FILE *f=fopen(path, "rb");
+  int ok;
+
+  if(!f)
+    return -1;
+  ok= fread(buf, 1, len, f)==len;
+  fclose(f);
+  return ok ? 0 : -1;
+}
+
+//------------------------------------------------------------------
+static int parse_key(const char *s, unsigned char *key)
+{
+  if(s[0]=='@')
+    return read_all(&s[1], key, 16);
+  if(strlen(s)!=32)
+    return -1;
+  //%x alone would accept blanks and signs
+  for(int i=0; i<32; i++)
+    if(!isxdigit((unsigned char)s[i]))
+      return -1;
+  for(int i=0; i<16; i++)
+  {
+    unsigned int v;
+
+    if(sscanf(&s[2*i], "%2x", &v)!=1)
+      return -1;
+    key[i]=(unsigned char)v;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+  unsigned char key[16], nonce[12];
+  unsigned long chunk_size=GCM_CHUNK_DEFAULT_SIZE, len=0;
+  unsigned long long off=0;
+  unsigned int nthreads=(unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+  const char *cmd, *keyarg=NULL;
+  int opt, in_fd, out_fd, status=-1;
+  gcm_chunk_header hdr;
+  struct stat sb;
+  gcm_ctxt g;
+
+  if(argc<2)
+    return usage(argv[0]), 1;
+  cmd=argv[1];
+  optind=2;
+  while((opt=getopt(argc, argv, "k:c:t:o:l:"))!=-1)
+  {
+    switch(opt)
+    {
+      case 'k':
+        keyarg=optarg;
+        break;
+      case 'c':
+        chunk_size=strtoul(optarg, NULL, 0);
+        break;
+      case 't':
+        nthreads=(unsigned int)strtoul(optarg, NULL, 0);
+        break;
+      case 'o':
+        off=strtoull(optarg, NULL, 0);
+        break;
+      case 'l':
+        len=strtoul(optarg, NULL, 0);
+        break;
+      default:
+        return usage(argv[0]), 1;
+    }
+  }
+  if(!keyarg || parse_key(keyarg, key) || argc-optind!=2)
+  {
+    aes128e_wipe(key, sizeof(key));
+    return usage(argv[0]), 1;
+  }
+  if((in_fd=open(argv[optind], O_RDONLY))<0)
+  {
+    perror(argv[optind]);
+    return 1;
+  }
+
+  if(gcm_init_key(&g, key))
+  {
+    fprintf(stderr, "%s: key setup failed\n", argv[0]);
+    aes128e_wipe(key, sizeof(key));
+    gcm_clear_key(&g);
+    close(in_fd);
+    return 1;
+  }
+  aes128e_wipe(key, sizeof(key));
+  if(!strcmp(cmd, "range"))
+  {
+    unsigned char *buf=malloc(len ? len : 1);
+
+    out_fd= strcmp(argv[optind+1], "-") ?
+            open(argv[optind+1], O_WRONLY|O_CREAT|O_TRUNC, 0600) :
+            STDOUT_FILENO;
+    if(buf && out_fd>=0 && !aes128gcm_chunk_read_header(in_fd, &hdr) &&
+       !aes128gcm_chunk_decrypt_range(&g, in_fd, &hdr, buf, off, len))
+      status= (write(out_fd, buf, len)==(ssize_t)len) ? 0 : -1;
+    if(buf)
+      aes128e_wipe(buf, len ? len : 1);
+    free(buf);
+  }
+  else if(!strcmp(cmd, "enc") || !strcmp(cmd, "dec"))
+  {
+    out_fd=open(argv[optind+1], O_RDWR|O_CREAT|O_TRUNC, 0600);
+    if(out_fd>=0 && !strcmp(cmd, "enc"))
+    {
+      if(!fstat(in_fd, &sb) && !read_all("/dev/urandom", nonce, 12) &&
+         !aes128gcm_chunk_header_init(&hdr, chunk_size,
+                                      (unsigned long long)sb.st_size, nonce))
+        status=aes128gcm_chunk_encrypt_fd(&g, out_fd, in_fd, &hdr,
+                                          nthreads);
+    }
+    else if(out_fd>=0)
+      status=aes128gcm_chunk_decrypt_fd(&g, out_fd, in_fd, nthreads);
+    //never leave a partial or unauthenticated file behind
+    if(out_fd>=0 && status)
+      unlink(argv[optind+1]);
+  }
+  else
+  {
+    usage(argv[0]);
+    out_fd=-1;
+  }
+
+  if(status)
+    fprintf(stderr, "%s: %s failed\n", argv[0], cmd);
+  if(out_fd>=0 && out_fd!=STDOUT_FILENO)
+    close(out_fd);
+  close(in_fd);
+  gcm_clear_key(&g);
+  return status ? 1 : 0;
+}
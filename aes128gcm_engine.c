@@ -0,0 +1,458 @@
+//-------------------------------------------------------------------
+// FILE: aes128gcm_engine.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  record engine. the rings are bounded arrays of job pointers where
+//  every slot carries a sequence number (the D. Vyukov queue), so any
+//  number of threads push and pop with one compare and swap and no
+//  lock. a worker has at most depth jobs outstanding, counted from
+//  submission until its completion is handed over, which keeps both
+//  of its rings from overflowing. idle workers yield and then sleep
+//-------------------------------------------------------------------
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "aes128gcm_engine.h"
+
+//empty passes before an idle worker starts sleeping
+#define IDLE_SPINS 256
+#define IDLE_SLEEP_NS 20000
+#define CACHE_LINE 64
+
+//definition of a ring slot
+typedef struct
+{
+  uint64_t seq;
+  gcm_engine_job *job;
+}ring_slot;
+
+//definition of a ring, head and tail on their own cache lines
+typedef struct
+{
+  ring_slot *slots;
+  uint64_t mask;//slots-1, a power of two minus one
+  char pad0[CACHE_LINE];
+  uint64_t head;//next push
+  char pad1[CACHE_LINE];
+  uint64_t tail;//next pop
+  char pad2[CACHE_LINE];
+}ring;
+
+//definition of a worker
+struct gcm_engine_worker
+{
+  gcm_engine *e;
+  pthread_t tid;
+  int started;
+  int stop;
+  ring sub;//submitted jobs
+  ring comp;//completed jobs, without a callback
+  unsigned long outstanding;
+  char pad[CACHE_LINE];
+  gcm_engine_stats st;//written by the worker only
+};
+
+//------------------------------------------------------------------
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec*1000000000ULL+(uint64_t)ts.tv_nsec;
+}
+
+//------------------------------------------------------------------
+static void bump(unsigned long long *c, unsigned long long v)
+{
+  __atomic_store_n(c, __atomic_load_n(c, __ATOMIC_RELAXED)+v,
+                   __ATOMIC_RELAXED);
+}
+
+//------------------------------------------------------------------
+static int ring_init(ring *r, unsigned int size)
+{
+  unsigned int n=1;
+
+  while(n<size)
+    n<<=1;
+  memset(r, 0, sizeof(*r));
+  if(!(r->slots=calloc(n, sizeof(ring_slot))))
+    return -1;
+  r->mask=n-1;
+  for(unsigned int i=0; i<n; i++)
+    r->slots[i].seq=i;
+  return 0;
+}
+
+//------------------------------------------------------------------
+//returns -1 if the ring is full
+static int ring_push(ring *r, gcm_engine_job *job)
+{
+  uint64_t pos=__atomic_load_n(&r->head, __ATOMIC_RELAXED);
+  ring_slot *s;
+
+  for(;;)
+  {
+    int64_t diff;
+
+    s=&r->slots[pos & r->mask];
+    diff=(int64_t)(__atomic_load_n(&s->seq, __ATOMIC_ACQUIRE)-pos);
+    if(!diff)
+    {
+      if(__atomic_compare_exchange_n(&r->head, &pos, pos+1, 1,
+                                     __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        break;
+    }
+    else if(diff<0)
+      return -1;
+    else
+      pos=__atomic_load_n(&r->head, __ATOMIC_RELAXED);
+  }
+  s->job=job;
+  __atomic_store_n(&s->seq, pos+1, __ATOMIC_RELEASE);
+  return 0;
+}
+
+//------------------------------------------------------------------
+//returns NULL if the ring is empty
+static gcm_engine_job *ring_pop(ring *r)
+{
+  uint64_t pos=__atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+  gcm_engine_job *job;
+  ring_slot *s;
+
+  for(;;)
+  {
+    int64_t diff;
+
+    s=&r->slots[pos & r->mask];
+    diff=(int64_t)(__atomic_load_n(&s->seq, __ATOMIC_ACQUIRE)-(pos+1));
+    if(!diff)
+    {
+      if(__atomic_compare_exchange_n(&r->tail, &pos, pos+1, 1,
+                                     __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        break;
+    }
+    else if(diff<0)
+      return NULL;
+    else
+      pos=__atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+  }
+  job=s->job;
+  __atomic_store_n(&s->seq, pos+r->mask+1, __ATOMIC_RELEASE);
+  return job;
+}
+
+//------------------------------------------------------------------
+static void complete(gcm_engine_worker *w, gcm_engine_job *job)
+{
+  uint64_t lat=now_ns()-job->submit_ns;
+
+  bump(&w->st.completed, 1);
+  bump(&w->st.failed, job->job.status ? 1 : 0);
+  bump(&w->st.latency_sum_ns, lat);
+  if(lat>w->st.latency_max_ns)
+    __atomic_store_n(&w->st.latency_max_ns, lat, __ATOMIC_RELAXED);
+
+  if(w->e->done)
+  {
+    //the slot is free before the callback, it may submit again
+    __atomic_fetch_sub(&w->outstanding, 1, __ATOMIC_RELEASE);
+    w->e->done(job, w->e->done_arg);
+    return;
+  }
+  //cannot stay full, the ring holds depth jobs
+  while(ring_push(&w->comp, job))
+    sched_yield();
+}
+
+//------------------------------------------------------------------
+static int is_small(const gcm_engine_job *job)
+{
+  return job->job.len<=GCM_ENGINE_BATCH_MAX_LEN;
+}
+
+//------------------------------------------------------------------
+//collects in grp the jobs of the window from i on that are small and
+//share the op and key context of jobs[i]. a job is left out when an
+//earlier job of its flow stays behind, so that every flow still
+//completes in submission order. returns the size of the group
+static unsigned int group_jobs(gcm_engine_job **jobs, unsigned int n,
+                               unsigned int i, const unsigned char *done,
+                               unsigned int *grp)
+{
+  unsigned char in[GCM_ENGINE_BATCH]={0};
+  unsigned int m=1;
+
+  grp[0]=i;
+  in[i]=1;
+  if(!is_small(jobs[i]))
+    return m;
+  for(unsigned int j=i+1; j<n; j++)
+  {
+    unsigned int k;
+
+    if(done[j] || !is_small(jobs[j]) || jobs[j]->op!=jobs[i]->op ||
+       jobs[j]->job.gctxt!=jobs[i]->job.gctxt)
+      continue;
+    for(k=i+1; k<j; k++)
+      if(!done[k] && !in[k] && jobs[k]->flow==jobs[j]->flow)
+        break;
+    if(k<j)
+      continue;
+    grp[m++]=j;
+    in[j]=1;
+  }
+  return m;
+}
+
+//------------------------------------------------------------------
+static void run_jobs(gcm_engine_worker *w, gcm_engine_job **jobs,
+                     unsigned int n)
+{
+  gcm_job batch[GCM_ENGINE_BATCH];
+  unsigned int grp[GCM_ENGINE_BATCH];
+  unsigned char done[GCM_ENGINE_BATCH]={0};
+
+  for(unsigned int i=0; i<n; i++)
+  {
+    gcm_engine_job *job=jobs[i];
+    unsigned int m;
+
+    if(done[i])
+      continue;
+    m=group_jobs(jobs, n, i, done, grp);
+    if(m>1)
+    {
+      for(unsigned int j=0; j<m; j++)
+        batch[j]=jobs[grp[j]]->job;
+      if(job->op==GCM_ENGINE_ENCRYPT)
+        aes128gcm_encrypt_batch(batch, m);
+      else
+        aes128gcm_decrypt_batch(batch, m);
+      for(unsigned int j=0; j<m; j++)
+      {
+        memcpy(jobs[grp[j]]->job.tag, batch[j].tag, sizeof(batch[j].tag));
+        jobs[grp[j]]->job.status=batch[j].status;
+      }
+      bump(&w->st.batches, 1);
+      bump(&w->st.batched, m);
+    }
+    else if(job->op==GCM_ENGINE_ENCRYPT)
+      job->job.status=aes128gcm_encrypt(job->job.gctxt, job->job.out,
+                                        job->job.tag, job->job.IV,
+                                        job->job.in, job->job.len,
+                                        job->job.add_data,
+                                        job->job.len_ad);
+    else
+      job->job.status=aes128gcm_decrypt(job->job.gctxt, job->job.out,
+                                        job->job.tag, job->job.IV,
+                                        job->job.in, job->job.len,
+                                        job->job.add_data,
+                                        job->job.len_ad,
+                                        GCM_VERIFY_FIRST);
+    for(unsigned int j=0; j<m; j++)
+    {
+      done[grp[j]]=1;
+      complete(w, jobs[grp[j]]);
+    }
+  }
+}
+
+//------------------------------------------------------------------
+static void idle_wait(unsigned int *idle)
+{
+  if(*idle<IDLE_SPINS)
+  {
+    (*idle)++;
+    sched_yield();
+  }
+  else
+  {
+    struct timespec ts={0, IDLE_SLEEP_NS};
+
+    nanosleep(&ts, NULL);
+  }
+}
+
+//------------------------------------------------------------------
+static void *worker_main(void *arg)
+{
+  gcm_engine_worker *w=(gcm_engine_worker *)arg;
+  gcm_engine_job *jobs[GCM_ENGINE_BATCH];
+  unsigned int idle=0;
+
+  for(;;)
+  {
+    //stop is read first, the ring is empty for good if it is set
+    int stop=__atomic_load_n(&w->stop, __ATOMIC_ACQUIRE);
+    unsigned long depth;
+    unsigned int n=0;
+
+    while(n<GCM_ENGINE_BATCH && (jobs[n]=ring_pop(&w->sub)))
+      n++;
+    if(!n)
+    {
+      if(stop)
+        break;
+      idle_wait(&idle);
+      continue;
+    }
+    idle=0;
+    depth=__atomic_load_n(&w->outstanding, __ATOMIC_RELAXED);
+    if(depth>w->st.max_depth)
+      __atomic_store_n(&w->st.max_depth, depth, __ATOMIC_RELAXED);
+    run_jobs(w, jobs, n);
+  }
+  return NULL;
+}
+
+//------------------------------------------------------------------
+static void pin_worker(pthread_t tid, unsigned int i)
+{
+#ifdef __linux__
+  long ncpu=sysconf(_SC_NPROCESSORS_ONLN);
+  cpu_set_t set;
+
+  if(ncpu<1)
+    return;
+  CPU_ZERO(&set);
+  CPU_SET(i%(unsigned long)ncpu, &set);
+  //best effort, the worker runs unpinned if this fails
+  pthread_setaffinity_np(tid, sizeof(set), &set);
+#else
+  (void)tid;
+  (void)i;
+#endif
+}
+
+//------------------------------------------------------------------
+int gcm_engine_init(gcm_engine *e, unsigned int nworkers,
+                    unsigned int depth, int pin,
+                    gcm_engine_done done, void *done_arg)
+{
+  memset(e, 0, sizeof(*e));
+  if(!nworkers || nworkers>GCM_ENGINE_MAX_WORKERS || !depth)
+    return -1;
+  if(!(e->workers=calloc(nworkers, sizeof(gcm_engine_worker))))
+    return -1;
+  e->nworkers=nworkers;
+  e->depth=depth;
+  e->done=done;
+  e->done_arg=done_arg;
+
+  for(unsigned int i=0; i<nworkers; i++)
+  {
+    gcm_engine_worker *w=&e->workers[i];
+
+    w->e=e;
+    if(ring_init(&w->sub, depth) || ring_init(&w->comp, depth) ||
+       pthread_create(&w->tid, NULL, worker_main, w))
+    {
+      gcm_engine_destroy(e);
+      return -1;
+    }
+    w->started=1;
+    if(pin)
+      pin_worker(w->tid, i);
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------
+int gcm_engine_submit(gcm_engine *e, gcm_engine_job *job)
+{
+  gcm_engine_worker *w=&e->workers[job->flow%e->nworkers];
+
+  if(__atomic_fetch_add(&w->outstanding, 1, __ATOMIC_ACQUIRE)>=e->depth)
+  {
+    __atomic_fetch_sub(&w->outstanding, 1, __ATOMIC_RELAXED);
+    return -1;
+  }
+  job->submit_ns=now_ns();
+  if(ring_push(&w->sub, job))
+  {
+    __atomic_fetch_sub(&w->outstanding, 1, __ATOMIC_RELAXED);
+    return -1;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------
+gcm_engine_job *gcm_engine_poll(gcm_engine *e)
+{
+  if(e->done)
+    return NULL;
+  for(unsigned int k=0; k<e->nworkers; k++)
+  {
+    unsigned int i=(e->poll_next+k)%e->nworkers;
+    gcm_engine_worker *w=&e->workers[i];
+    gcm_engine_job *job=ring_pop(&w->comp);
+
+    if(job)
+    {
+      __atomic_fetch_sub(&w->outstanding, 1, __ATOMIC_RELEASE);
+      e->poll_next=(i+1)%e->nworkers;
+      return job;
+    }
+  }
+  return NULL;
+}
+
+//------------------------------------------------------------------
+void gcm_engine_get_stats(gcm_engine *e, int worker,
+                          gcm_engine_stats *stats)
+{
+  unsigned int first= (worker<0) ? 0 : (unsigned int)worker;
+  unsigned int last= (worker<0) ? e->nworkers : first+1;
+
+  memset(stats, 0, sizeof(*stats));
+  for(unsigned int i=first; i<last && i<e->nworkers; i++)
+  {
+    gcm_engine_worker *w=&e->workers[i];
+    unsigned long long max;
+    unsigned long depth;
+
+    stats->completed+=__atomic_load_n(&w->st.completed, __ATOMIC_RELAXED);
+    stats->failed+=__atomic_load_n(&w->st.failed, __ATOMIC_RELAXED);
+    stats->batches+=__atomic_load_n(&w->st.batches, __ATOMIC_RELAXED);
+    stats->batched+=__atomic_load_n(&w->st.batched, __ATOMIC_RELAXED);
+    stats->latency_sum_ns+=__atomic_load_n(&w->st.latency_sum_ns,
+                                           __ATOMIC_RELAXED);
+    max=__atomic_load_n(&w->st.latency_max_ns, __ATOMIC_RELAXED);
+    if(max>stats->latency_max_ns)
+      stats->latency_max_ns=max;
+    stats->depth+=__atomic_load_n(&w->outstanding, __ATOMIC_RELAXED);
+    depth=__atomic_load_n(&w->st.max_depth, __ATOMIC_RELAXED);
+    if(depth>stats->max_depth)
+      stats->max_depth=depth;
+  }
+}
+
+//------------------------------------------------------------------
+void gcm_engine_destroy(gcm_engine *e)
+{
+  for(unsigned int i=0; i<e->nworkers; i++)
+    __atomic_store_n(&e->workers[i].stop, 1, __ATOMIC_RELEASE);
+  for(unsigned int i=0; i<e->nworkers; i++)
+  {
+    gcm_engine_worker *w=&e->workers[i];
+
+    if(w->started)
+      pthread_join(w->tid, NULL);
+    free(w->sub.slots);
+    free(w->comp.slots);
+  }
+  free(e->workers);
+  memset(e, 0, sizeof(*e));
+}
+
+//end of file
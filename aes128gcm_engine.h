@@ -0,0 +1,120 @@
+#ifndef AES128GCM_ENGINE_H
+#define AES128GCM_ENGINE_H
+//-------------------------------------------------------------------
+// FILE: aes128gcm_engine.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  asynchronous record engine for many producer threads. every
+//  worker thread owns a lock-free submission ring and a completion
+//  ring; a job goes to the worker of its flow, so the records of one
+//  flow are processed and completed in submission order. workers
+//  take several jobs per pass and run the small jobs of one key
+//  context and op through the batch interface. completions are
+//  handed to a callback on the worker or queued for gcm_engine_poll()
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+
+#include "aes128gcm_batch.h"
+
+//worker threads of an engine
+#define GCM_ENGINE_MAX_WORKERS 256
+//jobs a worker takes from its ring per pass
+#define GCM_ENGINE_BATCH 32
+//jobs up to this length are batched, longer ones run alone through
+//the single pass loops
+#define GCM_ENGINE_BATCH_MAX_LEN 64
+
+//operations of a job
+enum
+{
+  GCM_ENGINE_ENCRYPT=0,
+  GCM_ENGINE_DECRYPT //verifies the tag first, like GCM_VERIFY_FIRST
+};
+
+//definition of a job, owned by the caller until it completes
+typedef struct
+{
+  gcm_job job;//message, tag and status as in aes128gcm_batch.h
+  int op;//GCM_ENGINE_ENCRYPT or GCM_ENGINE_DECRYPT
+  unsigned long flow;//jobs of a flow complete in submission order
+  void *user;//free for the caller
+  uint64_t submit_ns;//set by gcm_engine_submit()
+}gcm_engine_job;
+
+//completion callback, runs on the worker thread
+typedef void (*gcm_engine_done)(gcm_engine_job *job, void *arg);
+
+typedef struct gcm_engine_worker gcm_engine_worker;
+
+//definition of an engine
+typedef struct
+{
+  gcm_engine_worker *workers;
+  unsigned int nworkers;
+  unsigned int depth;//outstanding jobs per worker
+  gcm_engine_done done;//NULL to queue completions for polling
+  void *done_arg;
+  unsigned int poll_next;//worker polled first
+}gcm_engine;
+
+//definition of the counters of one worker or of all
+typedef struct
+{
+  unsigned long long completed;
+  unsigned long long failed;//completed with status -1
+  unsigned long long batches;//batch interface calls
+  unsigned long long batched;//jobs run through them
+  unsigned long long latency_sum_ns;//submission to completion
+  unsigned long long latency_max_ns;
+  unsigned long depth;//jobs submitted and not yet completed
+  unsigned long max_depth;//largest depth seen by the worker
+}gcm_engine_stats;
+
+int gcm_engine_init(gcm_engine *e, unsigned int nworkers,
+                    unsigned int depth, int pin,
+                    gcm_engine_done done, void *done_arg);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  starts nworkers workers, each accepting up to depth outstanding
+//  jobs. with pin set and on Linux, worker i is bound to CPU i modulo
+//  the CPUs available. done is called for every completed job, or
+//  NULL to collect them with gcm_engine_poll(). returns 0 on
+//  success, -1 if nworkers is not in [1, GCM_ENGINE_MAX_WORKERS],
+//  depth is 0 or on allocation or thread creation failure
+//------------------------------------------------------------------
+
+int gcm_engine_submit(gcm_engine *e, gcm_engine_job *job);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  queues job on the worker of job->flow, lock-free and safe from
+//  any number of threads. the job and the buffers it points to must
+//  stay valid until it completes. returns 0, or -1 if the worker
+//  already has depth outstanding jobs
+//------------------------------------------------------------------
+
+gcm_engine_job *gcm_engine_poll(gcm_engine *e);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  returns a completed job, or NULL if none is ready or a callback
+//  was given to gcm_engine_init(). jobs of one flow are returned in
+//  submission order. meant for a single polling thread
+//------------------------------------------------------------------
+
+void gcm_engine_get_stats(gcm_engine *e, int worker,
+                          gcm_engine_stats *stats);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  counters of one worker, or summed over all of them if worker<0.
+//  the mean latency is latency_sum_ns/completed
+//------------------------------------------------------------------
+
+void gcm_engine_destroy(gcm_engine *e);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  lets the workers finish the submitted jobs, stops them and frees
+//  the engine. completions not polled by then are dropped
+//------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef AES128GCM_IMPL_H
+#define AES128GCM_IMPL_H
+
+//-------------------------------------------------------------------
+// FILE: aes128gcm_impl.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  internal helpers of aes128gcm.c shared with the modules built on
+//  top of it
+//-------------------------------------------------------------------
+
+#include "aes128gcm.h"
+
+void gcm_segment(const gcm_ctxt *gctxt, unsigned char *out,
+                 const unsigned char *in, unsigned long len,
+                 const unsigned char *ctr, unsigned char *Y, int decrypt);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  en/decrypts len bytes of a message starting at counter block ctr
+//  and writes the GHASH of that ciphertext segment alone (starting
+//  from zero, a trailing partial block zero padded) to Y
+//-------------------------------------------------------------------
+
+size_t gcm_htab_size(int backend);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  bytes of the per key table of a GHASH backend, 0 for GHASH_REF
+//-------------------------------------------------------------------
+
+void gcm_mul_hpow(unsigned char *Y, const unsigned char *H,
+                  unsigned long long e);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  Y=Y*H^e, used to shift a partial GHASH over the blocks following
+//  it so partial sums of segments can be combined
+//-------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,305 @@
+//-------------------------------------------------------------------
+// FILE: aes128gcm_iov.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  scatter-gather GCM. the input and output lists are walked side by
+//  side and every piece where both stay inside one segment goes to
+//  the streaming interface, which carries partial blocks between the
+//  pieces. the verify first decryption hashes the segments with its
+//  own partial block buffer and runs counter mode only afterwards
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+#include <string.h>
+
+#include "aes128gcm_iov.h"
+
+#define BLK_LEN 16
+
+//definition of a position in an iovec list
+typedef struct
+{
+  const struct iovec *iov;
+  unsigned int cnt;
+  unsigned int i;//current segment
+  size_t off;//offset in the current segment
+}iov_cursor;
+
+//handles len bytes at in and out, both contiguous
+typedef int (*piece_fn)(void *arg, unsigned char *out,
+                        const unsigned char *in, unsigned long len);
+
+//definition of the counter mode state of the second decryption pass
+typedef struct
+{
+  const key_ctxt *kctxt;
+  unsigned char ctr[BLK_LEN];//next unused counter block
+  unsigned char ks[BLK_LEN];//keystream of a partial block
+  unsigned int ks_used;//bytes of ks already used, BLK_LEN if none
+}ctr_state;
+
+//------------------------------------------------------------------
+static unsigned long long iov_total(const struct iovec *iov,
+                                    unsigned int cnt)
+{
+  unsigned long long len=0;
+
+  for(unsigned int i=0; i<cnt; i++)
+    len+=iov[i].iov_len;
+  return len;
+}
+
+//------------------------------------------------------------------
+//contiguous bytes at the cursor, empty segments are skipped. 0 at
+//the end of the list
+static size_t cursor_span(iov_cursor *c)
+{
+  while(c->i<c->cnt && c->off==c->iov[c->i].iov_len)
+  {
+    c->i++;
+    c->off=0;
+  }
+  return (c->i<c->cnt) ? c->iov[c->i].iov_len-c->off : 0;
+}
+
+//------------------------------------------------------------------
+static unsigned char *cursor_ptr(const iov_cursor *c)
+{
+  return (unsigned char *)c->iov[c->i].iov_base+c->off;
+}
+
+//------------------------------------------------------------------
+//runs fn over the first len bytes of the lists, split wherever a
+//segment of in or out ends. both lists hold at least len bytes
+static int walk_pairs(const struct iovec *out, unsigned int out_cnt,
+                      const struct iovec *in, unsigned int in_cnt,
+                      unsigned long long len, piece_fn fn, void *arg)
+{
+  iov_cursor o={out, out_cnt, 0, 0}, i={in, in_cnt, 0, 0};
+
+  while(len)
+  {
+    size_t n=cursor_span(&i), m=cursor_span(&o);
+
+    if(m<n)
+      n=m;
+    if(n>len)
+      n=(size_t)len;
+    if(fn(arg, cursor_ptr(&o), cursor_ptr(&i), n))
+      return -1;
+    i.off+=n;
+    o.off+=n;
+    len-=n;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------
+static int encrypt_piece(void *arg, unsigned char *out,
+                         const unsigned char *in, unsigned long len)
+{
+  return gcm_update((gcm_stream *)arg, out, in, len);
+}
+
+//------------------------------------------------------------------
+static int decrypt_piece(void *arg, unsigned char *out,
+                         const unsigned char *in, unsigned long len)
+{
+  return gcm_update_decrypt((gcm_stream *)arg, out, in, len);
+}
+
+//------------------------------------------------------------------
+static int wipe_piece(void *arg, unsigned char *out,
+                      const unsigned char *in, unsigned long len)
+{
+  (void)arg;
+  (void)in;
+  aes128e_wipe(out, len);
+  return 0;
+}
+
+//------------------------------------------------------------------
+static int ctr_piece(void *arg, unsigned char *out,
+                     const unsigned char *in, unsigned long len)
+{
+  ctr_state *cs=(ctr_state *)arg;
+  unsigned long nblocks;
+
+  //rest of the keystream of the previous piece
+  while(len && cs->ks_used<BLK_LEN)
+  {
+    *out++= *in++ ^ cs->ks[cs->ks_used++];
+    len--;
+  }
+
+  nblocks=len/BLK_LEN;
+  aes128e_ctr32(cs->kctxt, out, in, cs->ctr, nblocks);
+  in+=BLK_LEN*nblocks;
+  out+=BLK_LEN*nblocks;
+  len-=BLK_LEN*nblocks;
+
+  if(len)
+  {
+    memset(cs->ks, 0, BLK_LEN);
+    aes128e_ctr32(cs->kctxt, cs->ks, cs->ks, cs->ctr, 1);
+    for(unsigned long i=0; i<len; i++)
+      out[i]= in[i] ^ cs->ks[i];
+    cs->ks_used=(unsigned int)len;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------
+//GHASH of the concatenated segments, a trailing partial block zero
+//padded
+static void ghash_iov(const gcm_ctxt *g, unsigned char *Y,
+                      const struct iovec *iov, unsigned int cnt)
+{
+  unsigned char buf[BLK_LEN];
+  unsigned int buf_len=0;
+
+  for(unsigned int s=0; s<cnt; s++)
+  {
+    const unsigned char *X=(const unsigned char *)iov[s].iov_base;
+    size_t len=iov[s].iov_len, nblocks;
+
+    //complete a block split across segments first
+    while(len && buf_len)
+    {
+      buf[buf_len++]= *X++;
+      len--;
+      if(buf_len==BLK_LEN)
+      {
+        gcm_ghash(g, Y, buf, 1);
+        buf_len=0;
+      }
+    }
+    if(buf_len)
+      continue;
+    nblocks=len/BLK_LEN;
+    gcm_ghash(g, Y, X, nblocks);
+    X+=BLK_LEN*nblocks;
+    len-=BLK_LEN*nblocks;
+    if(len)
+      memcpy(buf, X, len);
+    buf_len=(unsigned int)len;
+  }
+  if(buf_len)
+  {
+    memset(&buf[buf_len], 0, BLK_LEN-buf_len);
+    gcm_ghash(g, Y, buf, 1);
+  }
+  aes128e_wipe(buf, sizeof(buf));
+}
+
+//------------------------------------------------------------------
+static void put_bitlen(unsigned char *out, unsigned long long len)
+{
+  len*=8;
+  for(int i=7; i>=0; i--, len>>=8)
+    out[i]=(unsigned char)len;
+}
+
+//------------------------------------------------------------------
+//starts a message, returns the plaintext length or -1 if the lists
+//do not fit
+static long long iov_start(gcm_stream *st, const gcm_ctxt *gctxt,
+                           const unsigned char *IV,
+                           const struct iovec *out, unsigned int out_cnt,
+                           const struct iovec *in, unsigned int in_cnt,
+                           const struct iovec *aad, unsigned int aad_cnt)
+{
+  unsigned long long len=iov_total(in, in_cnt);
+
+  if(len>GCM_MAX_PLAINTEXT || iov_total(out, out_cnt)<len)
+    return -1;
+  gcm_init(st, gctxt, IV);
+  for(unsigned int s=0; s<aad_cnt; s++)
+    gcm_update_aad(st, (const unsigned char *)aad[s].iov_base,
+                   aad[s].iov_len);
+  return (long long)len;
+}
+
+//------------------------------------------------------------------
+int aes128gcm_encrypt_iov(const gcm_ctxt *gctxt,
+                          const struct iovec *out, unsigned int out_cnt,
+                          unsigned char *tag,
+                          const unsigned char *IV,
+                          const struct iovec *in, unsigned int in_cnt,
+                          const struct iovec *aad, unsigned int aad_cnt)
+{
+  gcm_stream st;
+  long long len=iov_start(&st, gctxt, IV, out, out_cnt, in, in_cnt,
+                          aad, aad_cnt);
+
+  if(len<0)
+    return -1;
+  walk_pairs(out, out_cnt, in, in_cnt, (unsigned long long)len,
+             encrypt_piece, &st);
+  gcm_final(&st, tag);
+  return 0;
+}
+
+//------------------------------------------------------------------
+int aes128gcm_decrypt_iov(const gcm_ctxt *gctxt,
+                          const struct iovec *out, unsigned int out_cnt,
+                          const unsigned char *tag,
+                          const unsigned char *IV,
+                          const struct iovec *in, unsigned int in_cnt,
+                          const struct iovec *aad, unsigned int aad_cnt,
+                          int mode)
+{
+  unsigned char len_blk[BLK_LEN], calc[BLK_LEN], Y[BLK_LEN];
+  unsigned long long len=iov_total(in, in_cnt);
+  ctr_state cs;
+  gcm_stream st;
+  int ok;
+
+  if(mode!=GCM_VERIFY_FIRST)
+  {
+    long long n=iov_start(&st, gctxt, IV, out, out_cnt, in, in_cnt,
+                          aad, aad_cnt);
+
+    if(n<0)
+      return -1;
+    walk_pairs(out, out_cnt, in, in_cnt, len, decrypt_piece, &st);
+    if(gcm_final_verify(&st, tag))
+    {
+      walk_pairs(out, out_cnt, out, out_cnt, len, wipe_piece, NULL);
+      return -1;
+    }
+    return 0;
+  }
+
+  if(len>GCM_MAX_PLAINTEXT || iov_total(out, out_cnt)<len)
+    return -1;
+
+  //authenticate with GHASH alone, J0=IV||0^31||1
+  memset(Y, 0, BLK_LEN);
+  ghash_iov(gctxt, Y, aad, aad_cnt);
+  ghash_iov(gctxt, Y, in, in_cnt);
+  put_bitlen(len_blk, iov_total(aad, aad_cnt));
+  put_bitlen(&len_blk[8], len);
+  gcm_ghash(gctxt, Y, len_blk, 1);
+  memcpy(cs.ctr, IV, 12);
+  memset(&cs.ctr[12], 0, 3);
+  cs.ctr[15]=0x01;
+  aes128e_blocks(&gctxt->kctxt, calc, cs.ctr, 1);
+  xor_128(calc, Y, calc);
+  ok=gcm_tag_equal(calc, tag, BLK_LEN);
+  aes128e_wipe(calc, sizeof(calc));
+  aes128e_wipe(Y, sizeof(Y));
+  if(!ok)
+    return -1;
+
+  //the payload is only decrypted once the tag matched
+  cs.kctxt=&gctxt->kctxt;
+  cs.ctr[15]=0x02;
+  cs.ks_used=BLK_LEN;
+  walk_pairs(out, out_cnt, in, in_cnt, len, ctr_piece, &cs);
+  aes128e_wipe(&cs, sizeof(cs));
+  return 0;
+}
+
+//end of file
@@ -0,0 +1,54 @@
+#ifndef AES128GCM_IOV_H
+#define AES128GCM_IOV_H
+//-------------------------------------------------------------------
+// FILE: aes128gcm_iov.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  scatter-gather GCM over struct iovec lists, as handed to readv()
+//  and writev(), so chained packet buffers need not be copied into
+//  one flat buffer. segments may have any length, including zero,
+//  and may split blocks anywhere; partial blocks are carried inside.
+//  the output list may be laid out differently from the input list,
+//  byte i of the message is read from the input and written to the
+//  output at their own offset i. in place works when both lists
+//  describe the same memory
+//-------------------------------------------------------------------
+
+#include <sys/uio.h>
+
+#include "aes128gcm.h"
+
+int aes128gcm_encrypt_iov(const gcm_ctxt *gctxt,
+                          const struct iovec *out, unsigned int out_cnt,
+                          unsigned char *tag,
+                          const unsigned char *IV,
+                          const struct iovec *in, unsigned int in_cnt,
+                          const struct iovec *aad, unsigned int aad_cnt);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  encrypts the concatenation of the in segments under the 12-byte
+//  IV with the concatenation of the aad segments as associated data,
+//  writes the ciphertext over the out segments and the 16-byte tag.
+//  returns 0 on success, -1 if the out segments are shorter than the
+//  input or the input exceeds GCM_MAX_PLAINTEXT; nothing is written
+//  then
+//------------------------------------------------------------------
+
+int aes128gcm_decrypt_iov(const gcm_ctxt *gctxt,
+                          const struct iovec *out, unsigned int out_cnt,
+                          const unsigned char *tag,
+                          const unsigned char *IV,
+                          const struct iovec *in, unsigned int in_cnt,
+                          const struct iovec *aad, unsigned int aad_cnt,
+                          int mode);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  decrypting counterpart. with GCM_VERIFY_FIRST the tag is checked
+//  by a GHASH pass over the segments and the output is only written
+//  if it matches; with GCM_FUSED the output written so far is wiped
+//  when it does not. returns 0 if the message is authentic, -1
+//  otherwise or on the length errors of aes128gcm_encrypt_iov()
+//------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,333 @@
+//-------------------------------------------------------------------
+// FILE: aes128gcm_keycache.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  sharded LRU cache of key contexts. a miss expands the key outside
+//  the shard lock, a racing insert of the same key keeps the first
+//  context. keys are compared in constant time
+//-------------------------------------------------------------------
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aes128gcm_keycache.h"
+
+#define KEY_LEN 16
+
+//definition of a cached context
+struct gcm_keycache_entry
+{
+  gcm_ctxt gctxt;//first, the entry is found from the context
+  unsigned char key[KEY_LEN];
+  uint64_t hash;
+  size_t bytes;//footprint charged to the shard
+  unsigned int pins;
+  int removed;//unlinked, freed by the last release
+  gcm_keycache_entry *hnext;//bucket chain
+  gcm_keycache_entry *prev;//LRU list
+  gcm_keycache_entry *next;
+};
+
+//------------------------------------------------------------------
+//64-bit mix of the key words and the seed
+static uint64_t key_hash(const gcm_keycache *cache, const unsigned char *k)
+{
+  uint64_t a, b, h;
+
+  memcpy(&a, k, 8);
+  memcpy(&b, &k[8], 8);
+  h=cache->seed^a;
+  h=(h^(h >> 33))*0xff51afd7ed558ccdULL;
+  h^=b;
+  h=(h^(h >> 33))*0xc4ceb9fe1a85ec53ULL;
+  return h^(h >> 33);
+}
+
+//------------------------------------------------------------------
+static gcm_keycache_shard *shard_of(gcm_keycache *cache, uint64_t hash)
+{
+  return &cache->shards[(hash >> 32)%cache->nshards];
+}
+
+//------------------------------------------------------------------
+static gcm_keycache_entry **bucket_of(gcm_keycache_shard *sh, uint64_t hash)
+{
+  return &sh->buckets[hash & (sh->nbuckets-1)];
+}
+
+//------------------------------------------------------------------
+static void lru_unlink(gcm_keycache_shard *sh, gcm_keycache_entry *e)
+{
+  if(e->prev)
+    e->prev->next=e->next;
+  else
+    sh->lru_head=e->next;
+  if(e->next)
+    e->next->prev=e->prev;
+  else
+    sh->lru_tail=e->prev;
+  e->prev=e->next=NULL;
+}
+
+//------------------------------------------------------------------
+static void lru_push(gcm_keycache_shard *sh, gcm_keycache_entry *e)
+{
+  e->prev=NULL;
+  e->next=sh->lru_head;
+  if(sh->lru_head)
+    sh->lru_head->prev=e;
+  else
+    sh->lru_tail=e;
+  sh->lru_head=e;
+}
+
+//------------------------------------------------------------------
+static gcm_keycache_entry *find(gcm_keycache_shard *sh, uint64_t hash,
+                                const unsigned char *k)
+{
+  for(gcm_keycache_entry *e=*bucket_of(sh, hash); e; e=e->hnext)
+    if(e->hash==hash && gcm_tag_equal(e->key, k, KEY_LEN))
+      return e;
+  return NULL;
+}
+
+//------------------------------------------------------------------
+static void entry_free(gcm_keycache_entry *e)
+{
+  gcm_clear_key(&e->gctxt);
+  aes128e_wipe(e, sizeof(*e));
+  free(e);
+}
+
+//------------------------------------------------------------------
+//takes e out of the hash and the LRU list of sh
+static void entry_unlink(gcm_keycache_shard *sh, gcm_keycache_entry *e)
+{
+  gcm_keycache_entry **p=bucket_of(sh, e->hash);
+
+  while(*p!=e)
+    p=&(*p)->hnext;
+  *p=e->hnext;
+  lru_unlink(sh, e);
+  sh->bytes-=e->bytes;
+  sh->entries--;
+  e->removed=1;
+}
+
+//------------------------------------------------------------------
+//evicts unpinned entries from the cold end until sh fits its budget
+static void evict(gcm_keycache *cache, gcm_keycache_shard *sh)
+{
+  gcm_keycache_entry *e=sh->lru_tail;
+
+  while(e && sh->bytes>cache->shard_budget)
+  {
+    gcm_keycache_entry *prev=e->prev;
+
+    if(!e->pins)
+    {
+      entry_unlink(sh, e);
+      entry_free(e);
+      sh->evictions++;
+    }
+    e=prev;
+  }
+}
+
+//------------------------------------------------------------------
+int gcm_keycache_init(gcm_keycache *cache, size_t budget,
+                      unsigned int nshards, int ghash, uint64_t seed)
+{
+  unsigned long nbuckets=16;
+
+  if(!nshards || nshards>GCM_KEYCACHE_MAX_SHARDS)
+    return -1;
+  if(ghash>=0 && ghash!=gcm_default_ghash())
+  {
+    //the backend must be known and supported by the host
+    static const unsigned char zero[KEY_LEN];
+    gcm_ctxt probe;
+    int bad;
+
+    bad=gcm_init_key(&probe, zero) || gcm_set_ghash(&probe, ghash);
+    gcm_clear_key(&probe);
+    if(bad)
+      return -1;
+  }
+  cache->nshards=nshards;
+  cache->shard_budget=budget/nshards;
+  cache->seed=seed;
+  cache->ghash= (ghash<0) ? gcm_default_ghash() : ghash;
+
+  //about one bucket per context that fits a shard
+  while(nbuckets<(1UL << 24) &&
+        nbuckets*sizeof(gcm_keycache_entry)<cache->shard_budget)
+    nbuckets*=2;
+
+  cache->shards=calloc(nshards, sizeof(gcm_keycache_shard));
+  if(!cache->shards)
+    return -1;
+  for(unsigned int i=0; i<nshards; i++)
+  {
+    gcm_keycache_shard *sh=&cache->shards[i];
+
+    sh->nbuckets=nbuckets;
+    sh->buckets=calloc(nbuckets, sizeof(gcm_keycache_entry *));
+    if(!sh->buckets || pthread_mutex_init(&sh->lock, NULL))
+    {
+      free(sh->buckets);
+      while(i--)
+      {
+        pthread_mutex_destroy(&cache->shards[i].lock);
+        free(cache->shards[i].buckets);
+      }
+      free(cache->shards);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------
+const gcm_ctxt *gcm_keycache_get(gcm_keycache *cache,
+                                 const unsigned char *k)
+{
+  uint64_t hash=key_hash(cache, k);
+  gcm_keycache_shard *sh=shard_of(cache, hash);
+  gcm_keycache_entry *e, *fresh;
+
+  pthread_mutex_lock(&sh->lock);
+  e=find(sh, hash, k);
+  if(e)
+  {
+    sh->hits++;
+    e->pins++;
+    lru_unlink(sh, e);
+    lru_push(sh, e);
+    pthread_mutex_unlock(&sh->lock);
+    return &e->gctxt;
+  }
+  sh->misses++;
+  pthread_mutex_unlock(&sh->lock);
+
+  //expand outside the lock
+  fresh=malloc(sizeof(*fresh));
+  if(!fresh)
+    return NULL;
+  if(gcm_init_key(&fresh->gctxt, k) ||
+     (fresh->gctxt.ghash!=cache->ghash &&
+      gcm_set_ghash(&fresh->gctxt, cache->ghash)))
+  {
+    gcm_clear_key(&fresh->gctxt);
+    free(fresh);
+    return NULL;
+  }
+  memcpy(fresh->key, k, KEY_LEN);
+  fresh->hash=hash;
+  fresh->bytes=sizeof(*fresh)-sizeof(fresh->gctxt)+
+               gcm_key_footprint(&fresh->gctxt);
+  fresh->pins=1;
+  fresh->removed=0;
+
+  pthread_mutex_lock(&sh->lock);
+  e=find(sh, hash, k);
+  if(e)
+  {
+    //another thread inserted the key meanwhile
+    e->pins++;
+    lru_unlink(sh, e);
+    lru_push(sh, e);
+    pthread_mutex_unlock(&sh->lock);
+    entry_free(fresh);
+    return &e->gctxt;
+  }
+  fresh->hnext=*bucket_of(sh, hash);
+  *bucket_of(sh, hash)=fresh;
+  lru_push(sh, fresh);
+  sh->bytes+=fresh->bytes;
+  sh->entries++;
+  evict(cache, sh);
+  pthread_mutex_unlock(&sh->lock);
+  return &fresh->gctxt;
+}
+
+//------------------------------------------------------------------
+void gcm_keycache_release(gcm_keycache *cache, const gcm_ctxt *gctxt)
+{
+  gcm_keycache_entry *e=(gcm_keycache_entry *)
+                        ((char *)gctxt-offsetof(gcm_keycache_entry, gctxt));
+  gcm_keycache_shard *sh=shard_of(cache, e->hash);
+  int drop;
+
+  pthread_mutex_lock(&sh->lock);
+  drop= !--e->pins && e->removed;
+  //a pinned entry may have kept the shard over its budget
+  if(!e->pins && !e->removed && sh->bytes>cache->shard_budget)
+    evict(cache, sh);
+  pthread_mutex_unlock(&sh->lock);
+  if(drop)
+    entry_free(e);
+}
+
+//------------------------------------------------------------------
+void gcm_keycache_remove(gcm_keycache *cache, const unsigned char *k)
+{
+  uint64_t hash=key_hash(cache, k);
+  gcm_keycache_shard *sh=shard_of(cache, hash);
+  gcm_keycache_entry *e;
+  int drop=0;
+
+  pthread_mutex_lock(&sh->lock);
+  e=find(sh, hash, k);
+  if(e)
+  {
+    entry_unlink(sh, e);
+    drop= !e->pins;
+  }
+  pthread_mutex_unlock(&sh->lock);
+  if(drop)
+    entry_free(e);
+}
+
+//------------------------------------------------------------------
+void gcm_keycache_get_stats(gcm_keycache *cache, gcm_keycache_stats *stats)
+{
+  memset(stats, 0, sizeof(*stats));
+  for(unsigned int i=0; i<cache->nshards; i++)
+  {
+    gcm_keycache_shard *sh=&cache->shards[i];
+
+    pthread_mutex_lock(&sh->lock);
+    stats->hits+=sh->hits;
+    stats->misses+=sh->misses;
+    stats->evictions+=sh->evictions;
+    stats->entries+=sh->entries;
+    stats->bytes+=sh->bytes;
+    pthread_mutex_unlock(&sh->lock);
+  }
+}
+
+//------------------------------------------------------------------
+void gcm_keycache_destroy(gcm_keycache *cache)
+{
+  for(unsigned int i=0; i<cache->nshards; i++)
+  {
+    gcm_keycache_shard *sh=&cache->shards[i];
+
+    while(sh->lru_head)
+    {
+      gcm_keycache_entry *e=sh->lru_head;
+
+      entry_unlink(sh, e);
+      entry_free(e);
+    }
+    pthread_mutex_destroy(&sh->lock);
+    free(sh->buckets);
+  }
+  free(cache->shards);
+  aes128e_wipe(cache, sizeof(*cache));
+}
+
+//end of file
@@ -0,0 +1,105 @@
+#ifndef AES128GCM_KEYCACHE_H
+#define AES128GCM_KEYCACHE_H
+//-------------------------------------------------------------------
+// FILE: aes128gcm_keycache.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  thread safe cache of expanded key contexts (round keys, H and the
+//  GHASH table) keyed by the raw 16-byte key. the cache is split in
+//  shards with their own lock, LRU list and share of the memory
+//  budget. contexts handed out are pinned until released and never
+//  evicted while pinned; evicted and removed contexts are wiped
+//-------------------------------------------------------------------
+
+#include <pthread.h>
+
+#include "aes128gcm.h"
+
+#define GCM_KEYCACHE_MAX_SHARDS 256
+
+typedef struct gcm_keycache_entry gcm_keycache_entry;
+
+//definition of one shard
+typedef struct
+{
+  pthread_mutex_t lock;
+  gcm_keycache_entry **buckets;
+  unsigned long nbuckets;//power of two
+  gcm_keycache_entry *lru_head;//most recently used
+  gcm_keycache_entry *lru_tail;//least recently used
+  size_t bytes;//footprint of the cached contexts
+  unsigned long entries;
+  unsigned long long hits;
+  unsigned long long misses;
+  unsigned long long evictions;
+}gcm_keycache_shard;
+
+//definition of the cache
+typedef struct
+{
+  gcm_keycache_shard *shards;
+  unsigned int nshards;
+  size_t shard_budget;//bytes per shard
+  uint64_t seed;//bucket hash seed
+  int ghash;//GHASH backend of new contexts
+}gcm_keycache;
+
+//definition of the counters of a cache
+typedef struct
+{
+  unsigned long long hits;
+  unsigned long long misses;
+  unsigned long long evictions;
+  unsigned long entries;
+  size_t bytes;
+}gcm_keycache_stats;
+
+int gcm_keycache_init(gcm_keycache *cache, size_t budget,
+                      unsigned int nshards, int ghash, uint64_t seed);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  sets up a cache holding at most budget bytes of key contexts
+//  (gcm_key_footprint() plus the entry) in nshards shards. ghash is
+//  the GHASH backend of new contexts, -1 for gcm_default_ghash().
+//  seed randomizes the bucket hash, pass a random value. returns 0 on
+//  success, -1 if nshards is not in [1, GCM_KEYCACHE_MAX_SHARDS],
+//  ghash is unknown or not supported by the host, or on allocation
+//  failure
+//------------------------------------------------------------------
+
+const gcm_ctxt *gcm_keycache_get(gcm_keycache *cache,
+                                 const unsigned char *k);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  returns the context of the 16-byte key k, expanding it on a miss,
+//  and pins it. every get is paired with gcm_keycache_release().
+//  least recently used unpinned contexts are evicted to keep the
+//  shard within its budget. returns NULL on allocation failure
+//------------------------------------------------------------------
+
+void gcm_keycache_release(gcm_keycache *cache, const gcm_ctxt *gctxt);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  unpins a context returned by gcm_keycache_get()
+//------------------------------------------------------------------
+
+void gcm_keycache_remove(gcm_keycache *cache, const unsigned char *k);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  drops the key k, for example at the end of its session. the
+//  context is wiped at once, or when its last pin is released
+//------------------------------------------------------------------
+
+void gcm_keycache_get_stats(gcm_keycache *cache, gcm_keycache_stats *stats);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  sums the counters of all shards
+//------------------------------------------------------------------
+
+void gcm_keycache_destroy(gcm_keycache *cache);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  wipes and frees every context, none may be pinned
+//------------------------------------------------------------------
+#endif
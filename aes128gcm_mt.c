@@ -0,0 +1,172 @@
+//-------------------------------------------------------------------
+// FILE: aes128gcm_mt.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  multi-threaded GCM over one message. with Y_A the GHASH of the
+//  padded AAD, Y_i the GHASH of segment i alone and M the number of
+//  ciphertext blocks, the GHASH before the length block is
+//    Y_A*H^M ^ sum_i Y_i*H^(M-end_i)
+//  where end_i counts the blocks up to the end of segment i
+//-------------------------------------------------------------------
+
+#include <pthread.h>
+#include <string.h>
+
+#include "aes128gcm_mt.h"
+#include "aes128gcm_impl.h"
+
+#define BLK_LEN 16
+#define MAX_THREADS 256
+
+//definition of the work of one thread
+typedef struct
+{
+  const gcm_ctxt *gctxt;
+  unsigned char *out;
+  const unsigned char *in;
+  unsigned long len;//bytes of the segment
+  unsigned char ctr[BLK_LEN];//first counter block of the segment
+  unsigned char Y[BLK_LEN];//GHASH of the segment alone
+  int decrypt;
+}segment;
+
+//------------------------------------------------------------------
+static void *segment_worker(void *arg)
+{
+  segment *seg=(segment *)arg;
+
+  gcm_segment(seg->gctxt, seg->out, seg->in, seg->len, seg->ctr, seg->Y,
+              seg->decrypt);
+  return NULL;
+}
+
+//------------------------------------------------------------------
+//ctr=ctr0+n on the last 32 bits, big endian
+static void add32(unsigned char *ctr, const unsigned char *ctr0,
+                  unsigned long n)
+{
+  uint32_t c= ((uint32_t)ctr0[12] << 24) | ((uint32_t)ctr0[13] << 16) |
+              ((uint32_t)ctr0[14] << 8) | (uint32_t)ctr0[15];
+
+  memcpy(ctr, ctr0, 12);
+  c+=(uint32_t)n;
+  ctr[12]=(unsigned char)(c >> 24);
+  ctr[13]=(unsigned char)(c >> 16);
+  ctr[14]=(unsigned char)(c >> 8);
+  ctr[15]=(unsigned char)c;
+}
+
+//------------------------------------------------------------------
+//runs the payload in segments and leaves the combined GHASH in st
+static void gcm_crypt_mt(gcm_stream *st, unsigned char *out,
+                         const unsigned char *in, unsigned long len,
+                         unsigned int nthreads, int decrypt)
+{
+  segment seg[MAX_THREADS];
+  pthread_t tid[MAX_THREADS];
+  int started[MAX_THREADS];
+  unsigned long nblocks=(len+BLK_LEN-1)/BLK_LEN;
+  unsigned long per, off;
+  unsigned int n;
+
+  //close the AAD, st->Y is now the padded AAD hash
+  gcm_update(st, NULL, NULL, 0);
+
+  n= nthreads ? nthreads : 1;
+  if(n>MAX_THREADS)
+    n=MAX_THREADS;
+  if(n>len/GCM_MT_MIN_SEGMENT)
+    n= len/GCM_MT_MIN_SEGMENT ? (unsigned int)(len/GCM_MT_MIN_SEGMENT) : 1;
+
+  //segments of whole 8 block groups, the last one takes the rest
+  per=(nblocks/n) & ~7UL;
+  off=0;
+  for(unsigned int i=0; i<n; i++)
+  {
+    unsigned long blocks= (i==n-1) ? nblocks-off/BLK_LEN : per;
+
+    seg[i].gctxt=st->gctxt;
+    seg[i].out=out+off;
+    seg[i].in=in+off;
+    seg[i].len= (i==n-1) ? len-off : BLK_LEN*blocks;
+    seg[i].decrypt=decrypt;
+    add32(seg[i].ctr, st->ctr, off/BLK_LEN);
+    off+=seg[i].len;
+  }
+
+  //the calling thread takes the first segment, a segment whose
+  //thread cannot be created runs inline
+  for(unsigned int i=1; i<n; i++)
+    started[i]= !pthread_create(&tid[i], NULL, segment_worker, &seg[i]);
+  segment_worker(&seg[0]);
+  for(unsigned int i=1; i<n; i++)
+  {
+    if(started[i])
+      pthread_join(tid[i], NULL);
+    else
+      segment_worker(&seg[i]);
+  }
+
+  //combine, Y=Y_A*H^M ^ sum Y_i*H^(M-end_i)
+  gcm_mul_hpow(st->Y, st->gctxt->H, nblocks);
+  off=0;
+  for(unsigned int i=0; i<n; i++)
+  {
+    off+=(seg[i].len+BLK_LEN-1)/BLK_LEN;
+    gcm_mul_hpow(seg[i].Y, st->gctxt->H, nblocks-off);
+    xor_128(st->Y, seg[i].Y, st->Y);
+  }
+  st->len_p=len;
+  aes128e_wipe(seg, sizeof(seg));
+}
+
+//------------------------------------------------------------------
+int aes128gcm_encrypt_mt( const gcm_ctxt *gctxt,
+                          unsigned char *ciphertext,
+                          unsigned char *tag,
+                          const unsigned char *IV,
+                          const unsigned char *plaintext,
+                          const unsigned long len_p,
+                          const unsigned char *add_data,
+                          const unsigned long len_ad,
+                          unsigned int nthreads)
+{
+  gcm_stream st;
+
+  if(len_p > GCM_MAX_PLAINTEXT)
+    return -1;
+  gcm_init(&st, gctxt, IV);
+  gcm_update_aad(&st, add_data, len_ad);
+  gcm_crypt_mt(&st, ciphertext, plaintext, len_p, nthreads, 0);
+  gcm_final(&st, tag);
+  return 0;
+}
+
+//------------------------------------------------------------------
+int aes128gcm_decrypt_mt( const gcm_ctxt *gctxt,
+                          unsigned char *plaintext,
+                          const unsigned char *tag,
+                          const unsigned char *IV,
+                          const unsigned char *ciphertext,
+                          const unsigned long len_c,
+                          const unsigned char *add_data,
+                          const unsigned long len_ad,
+                          unsigned int nthreads)
+{
+  gcm_stream st;
+
+  if(len_c > GCM_MAX_PLAINTEXT)
+    return -1;
+  gcm_init(&st, gctxt, IV);
+  gcm_update_aad(&st, add_data, len_ad);
+  gcm_crypt_mt(&st, plaintext, ciphertext, len_c, nthreads, 1);
+  if(gcm_final_verify(&st, tag))
+  {
+    aes128e_wipe(plaintext, len_c);
+    return -1;
+  }
+  return 0;
+}
+
+//end of file
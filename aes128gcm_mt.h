@@ -0,0 +1,55 @@
+#ifndef AES128GCM_MT_H
+#define AES128GCM_MT_H
+//-------------------------------------------------------------------
+// FILE: aes128gcm_mt.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  multi-threaded encryption and decryption of a single message. the
+//  payload is split into block aligned segments, every thread runs
+//  counter mode from the segment's own counter offset and a GHASH
+//  over its segment, the partial hashes are combined with powers of
+//  H. output and tag are bit identical to aes128gcm_encrypt()
+//-------------------------------------------------------------------
+
+#include "aes128gcm.h"
+
+//smallest segment handed to a thread, smaller messages use fewer
+//threads
+#define GCM_MT_MIN_SEGMENT (64*1024)
+
+int aes128gcm_encrypt_mt( const gcm_ctxt *gctxt,
+                          unsigned char *ciphertext,
+                          unsigned char *tag,
+                          const unsigned char *IV,
+                          const unsigned char *plaintext,
+                          const unsigned long len_p,
+                          const unsigned char *add_data,
+                          const unsigned long len_ad,
+                          unsigned int nthreads
+                          );
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  aes128gcm_encrypt() spread over up to nthreads threads, the
+//  calling thread included. returns 0 on success, -1 if len_p
+//  exceeds GCM_MAX_PLAINTEXT
+//------------------------------------------------------------------
+
+int aes128gcm_decrypt_mt( const gcm_ctxt *gctxt,
+                          unsigned char *plaintext,
+                          const unsigned char *tag,
+                          const unsigned char *IV,
+                          const unsigned char *ciphertext,
+                          const unsigned long len_c,
+                          const unsigned char *add_data,
+                          const unsigned long len_ad,
+                          unsigned int nthreads
+                          );
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  single pass decryption spread over up to nthreads threads, like
+//  GCM_FUSED the plaintext is wiped if the tag does not match.
+//  returns 0 if the message is authentic, -1 otherwise
+//------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,81 @@
+//-------------------------------------------------------------------
+// FILE: aes128gcm_nonce.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  deterministic IV construction. a range is reserved with a compare
+//  and swap of the shared counter that never moves it past the limit,
+//  a range reaching beyond it is cut at the limit. once the counter
+//  is at the limit reservations fail without writing it, so it
+//  cannot wrap however often callers retry
+//-------------------------------------------------------------------
+
+#include <string.h>
+
+#include "aes128gcm_nonce.h"
+
+//------------------------------------------------------------------
+int gcm_nonce_init(gcm_nonce_source *src, const unsigned char *fixed,
+                   uint64_t limit, uint64_t rekey_at)
+{
+  if(limit>GCM_NONCE_MAX_LIMIT)
+    return -1;
+  memcpy(src->fixed, fixed, 4);
+  src->next=0;
+  src->limit= limit ? limit : GCM_NONCE_MAX_LIMIT;
+  src->rekey_at= rekey_at ? rekey_at : src->limit;
+  return 0;
+}
+
+//------------------------------------------------------------------
+void gcm_nonce_lease_init(gcm_nonce_lease *lease, gcm_nonce_source *src,
+                          unsigned int chunk)
+{
+  lease->src=src;
+  lease->next=lease->end=0;
+  lease->spent=0;
+  lease->chunk= chunk ? chunk : GCM_NONCE_DEFAULT_CHUNK;
+}
+
+//------------------------------------------------------------------
+int gcm_nonce_next(gcm_nonce_lease *lease, unsigned char *IV)
+{
+  gcm_nonce_source *src=lease->src;
+  uint64_t n;
+
+  if(lease->next==lease->end)
+  {
+    uint64_t start=__atomic_load_n(&src->next, __ATOMIC_RELAXED), end;
+
+    do
+    {
+      if(lease->spent || start>=src->limit)
+      {
+        lease->spent=1;
+        return -1;
+      }
+      end= (src->limit-start > lease->chunk) ?
+           start+lease->chunk : src->limit;
+    }while(!__atomic_compare_exchange_n(&src->next, &start, end, 0,
+                                        __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED));
+    lease->next=start;
+    lease->end=end;
+  }
+  n=lease->next++;
+
+  memcpy(IV, src->fixed, 4);
+  for(int i=11; i>=4; i--, n>>=8)
+    IV[i]=(unsigned char)n;
+  return (lease->next>src->rekey_at) ? GCM_NONCE_REKEY : GCM_NONCE_OK;
+}
+
+//------------------------------------------------------------------
+int gcm_nonce_rekey_due(const gcm_nonce_source *src)
+{
+  uint64_t next=__atomic_load_n(&src->next, __ATOMIC_RELAXED);
+
+  return next>=src->rekey_at || next>=src->limit;
+}
+
+//end of file
@@ -0,0 +1,87 @@
+#ifndef AES128GCM_NONCE_H
+#define AES128GCM_NONCE_H
+//-------------------------------------------------------------------
+// FILE: aes128gcm_nonce.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  deterministic 12-byte IVs after SP 800-38D 8.2.1: a 4-byte fixed
+//  field naming the instance followed by a 64-bit big endian
+//  invocation field. a source hands out invocation numbers of one
+//  key; every thread holds a lease that reserves a range of them
+//  with one compare and swap and issues IVs from it without touching shared
+//  memory. numbers left in a lease are never issued again, so IVs are
+//  unique under the key whatever the threads do. one source serves
+//  one key: after a rekey start a new source and new leases. threads
+//  with their own fixed fields may each use a source of their own
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+
+//largest invocation limit
+#define GCM_NONCE_MAX_LIMIT (1ULL << 62)
+//invocation numbers reserved by a lease at once
+#define GCM_NONCE_DEFAULT_CHUNK 1024
+
+//results of gcm_nonce_next()
+enum
+{
+  GCM_NONCE_OK=0,
+  GCM_NONCE_REKEY //IV issued, the rekey threshold is reached
+};
+
+//definition of the invocation numbers of one key
+typedef struct
+{
+  unsigned char fixed[4];
+  uint64_t next;//first number not reserved by a lease, atomic
+  uint64_t limit;//numbers that may be issued under the key
+  uint64_t rekey_at;//numbers from which GCM_NONCE_REKEY is returned
+}gcm_nonce_source;
+
+//definition of the reservation of one thread
+typedef struct
+{
+  gcm_nonce_source *src;
+  uint64_t next;//next number to issue
+  uint64_t end;//end of the reserved range
+  unsigned int chunk;
+  int spent;//set once the limit was reached, later calls fail at once
+}gcm_nonce_lease;
+
+int gcm_nonce_init(gcm_nonce_source *src, const unsigned char *fixed,
+                   uint64_t limit, uint64_t rekey_at);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  starts the invocation numbers of a fresh key with the 4-byte fixed
+//  field. at most limit IVs are issued, 0 means GCM_NONCE_MAX_LIMIT;
+//  from rekey_at on they come with GCM_NONCE_REKEY, 0 means never.
+//  returns 0 on success, -1 if limit exceeds GCM_NONCE_MAX_LIMIT
+//------------------------------------------------------------------
+
+void gcm_nonce_lease_init(gcm_nonce_lease *lease, gcm_nonce_source *src,
+                          unsigned int chunk);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  a lease of the calling thread on src reserving chunk numbers at a
+//  time, 0 for GCM_NONCE_DEFAULT_CHUNK. nothing is reserved yet
+//------------------------------------------------------------------
+
+int gcm_nonce_next(gcm_nonce_lease *lease, unsigned char *IV);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  writes the next 12-byte IV of the lease, reserving a new range
+//  when the current one is used up. returns GCM_NONCE_OK,
+//  GCM_NONCE_REKEY when the key should be replaced soon, or -1 with
+//  nothing written once the limit of the key is reached. a failed
+//  call leaves the source untouched
+//------------------------------------------------------------------
+
+int gcm_nonce_rekey_due(const gcm_nonce_source *src);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  returns 1 if the numbers reserved so far reached the rekey
+//  threshold or the limit, 0 otherwise
+//------------------------------------------------------------------
+
+#endif
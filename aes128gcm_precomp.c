@@ -0,0 +1,196 @@
+//-------------------------------------------------------------------
+// FILE: aes128gcm_precomp.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  GCM with a keystream computed before the payload is known. the
+//  XOR runs in groups small enough that the ciphertext of a group is
+//  still in L1 when it is hashed
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aes128gcm_precomp.h"
+
+#define BLK_LEN 16
+#define FUSE_BLOCKS 32
+
+//------------------------------------------------------------------
+static void xor_bytes(unsigned char *out, const unsigned char *in,
+                      const unsigned char *ks, unsigned long len)
+{
+  unsigned long i=0;
+
+  for(; i+8<=len; i+=8)
+  {
+    uint64_t a, b;
+
+    memcpy(&a, &in[i], 8);
+    memcpy(&b, &ks[i], 8);
+    a^=b;
+    memcpy(&out[i], &a, 8);
+  }
+  for(; i<len; i++)
+    out[i]=in[i]^ks[i];
+}
+
+//------------------------------------------------------------------
+//GHASH of len bytes, a trailing partial block zero padded
+static void ghash_padded(const gcm_ctxt *g, unsigned char *Y,
+                         const unsigned char *X, unsigned long len)
+{
+  unsigned char blk[BLK_LEN];
+  unsigned long n=len%BLK_LEN;
+
+  gcm_ghash(g, Y, X, len/BLK_LEN);
+  if(n)
+  {
+    memset(blk, 0, BLK_LEN);
+    memcpy(blk, &X[len-n], n);
+    gcm_ghash(g, Y, blk, 1);
+  }
+}
+
+//------------------------------------------------------------------
+//completes the GHASH with the length block into the tag
+static void precomp_tag(const gcm_keystream *ks, unsigned char *Y,
+                        unsigned long long len_ad, unsigned long long len,
+                        unsigned char *tag)
+{
+  unsigned char len_blk[BLK_LEN];
+
+  len_ad*=8;
+  len*=8;
+  for(int i=7; i>=0; i--, len_ad>>=8, len>>=8)
+  {
+    len_blk[i]=(unsigned char)len_ad;
+    len_blk[8+i]=(unsigned char)len;
+  }
+  gcm_ghash(ks->gctxt, Y, len_blk, 1);
+  xor_128(ks->ej0, Y, tag);
+}
+
+//------------------------------------------------------------------
+static void keystream_wipe(gcm_keystream *ks)
+{
+  aes128e_wipe(ks->ks, ks->len);
+  aes128e_wipe(ks->ej0, sizeof(ks->ej0));
+  ks->len=0;
+  ks->ready=0;
+}
+
+//------------------------------------------------------------------
+int gcm_keystream_init(gcm_keystream *ks, unsigned long max_len)
+{
+  ks->cap=(max_len+BLK_LEN-1) & ~(unsigned long)(BLK_LEN-1);
+  ks->ks=malloc(ks->cap ? ks->cap : BLK_LEN);
+  ks->gctxt=NULL;
+  ks->len=0;
+  ks->ready=0;
+  memset(ks->ej0, 0, sizeof(ks->ej0));
+  return ks->ks ? 0 : -1;
+}
+
+//------------------------------------------------------------------
+int gcm_keystream_prepare(gcm_keystream *ks, const gcm_ctxt *gctxt,
+                          const unsigned char *IV, unsigned long len)
+{
+  unsigned char ctr[BLK_LEN];
+  unsigned long nblocks=(len+BLK_LEN-1)/BLK_LEN;
+
+  if(ks->ready)
+    keystream_wipe(ks);
+  if(len>ks->cap || len>GCM_MAX_PLAINTEXT)
+    return -1;
+
+  //J0=IV||0^31||1, E(K,J0) first and the data from inc32(J0)
+  memcpy(ctr, IV, 12);
+  memset(&ctr[12], 0, 3);
+  ctr[15]=0x01;
+  aes128e_blocks(&gctxt->kctxt, ks->ej0, ctr, 1);
+  ctr[15]=0x02;
+  memset(ks->ks, 0, BLK_LEN*nblocks);
+  aes128e_ctr32(&gctxt->kctxt, ks->ks, ks->ks, ctr, nblocks);
+
+  ks->gctxt=gctxt;
+  ks->len=BLK_LEN*nblocks;
+  ks->ready=1;
+  aes128e_wipe(ctr, sizeof(ctr));
+  return 0;
+}
+
+//------------------------------------------------------------------
+int aes128gcm_encrypt_precomp(gcm_keystream *ks,
+                              unsigned char *ciphertext,
+                              unsigned char *tag,
+                              const unsigned char *plaintext,
+                              const unsigned long len_p,
+                              const unsigned char *add_data,
+                              const unsigned long len_ad)
+{
+  unsigned char Y[BLK_LEN];
+  unsigned long off;
+
+  if(!ks->ready || len_p>ks->len)
+    return -1;
+  memset(Y, 0, BLK_LEN);
+  ghash_padded(ks->gctxt, Y, add_data, len_ad);
+
+  //whole groups, then the tail with its partial block
+  for(off=0; len_p-off>=BLK_LEN*FUSE_BLOCKS; off+=BLK_LEN*FUSE_BLOCKS)
+  {
+    xor_bytes(&ciphertext[off], &plaintext[off], &ks->ks[off],
+              BLK_LEN*FUSE_BLOCKS);
+    gcm_ghash(ks->gctxt, Y, &ciphertext[off], FUSE_BLOCKS);
+  }
+  xor_bytes(&ciphertext[off], &plaintext[off], &ks->ks[off], len_p-off);
+  ghash_padded(ks->gctxt, Y, &ciphertext[off], len_p-off);
+
+  precomp_tag(ks, Y, len_ad, len_p, tag);
+  keystream_wipe(ks);
+  aes128e_wipe(Y, sizeof(Y));
+  return 0;
+}
+
+//------------------------------------------------------------------
+int aes128gcm_decrypt_precomp(gcm_keystream *ks,
+                              unsigned char *plaintext,
+                              const unsigned char *tag,
+                              const unsigned char *ciphertext,
+                              const unsigned long len_c,
+                              const unsigned char *add_data,
+                              const unsigned long len_ad)
+{
+  unsigned char Y[BLK_LEN], calc[BLK_LEN];
+  int ok;
+
+  if(!ks->ready || len_c>ks->len)
+    return -1;
+  memset(Y, 0, BLK_LEN);
+  ghash_padded(ks->gctxt, Y, add_data, len_ad);
+  ghash_padded(ks->gctxt, Y, ciphertext, len_c);
+  precomp_tag(ks, Y, len_ad, len_c, calc);
+
+  ok=gcm_tag_equal(calc, tag, BLK_LEN);
+  if(ok)
+    xor_bytes(plaintext, ciphertext, ks->ks, len_c);
+  keystream_wipe(ks);
+  aes128e_wipe(Y, sizeof(Y));
+  aes128e_wipe(calc, sizeof(calc));
+  return ok ? 0 : -1;
+}
+
+//------------------------------------------------------------------
+void gcm_keystream_clear(gcm_keystream *ks)
+{
+  if(ks->ks)
+  {
+    aes128e_wipe(ks->ks, ks->cap);
+    free(ks->ks);
+  }
+  aes128e_wipe(ks, sizeof(*ks));
+}
+
+//end of file
@@ -0,0 +1,82 @@
+#ifndef AES128GCM_PRECOMP_H
+#define AES128GCM_PRECOMP_H
+//-------------------------------------------------------------------
+// FILE: aes128gcm_precomp.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  keystream precomputation for messages whose IV is known before
+//  the payload. gcm_keystream_prepare() runs all AES work of the
+//  message (E(K,J0) and the counter blocks) ahead of time, H and its
+//  GHASH table already live in the gcm_ctxt, so the send step is one
+//  XOR and one GHASH pass. a prepared keystream serves exactly one
+//  message and is wiped when it is used or cleared
+//-------------------------------------------------------------------
+
+#include "aes128gcm.h"
+
+//definition of a precomputed keystream
+typedef struct
+{
+  const gcm_ctxt *gctxt;//key context of the prepared IV
+  unsigned char ej0[16];//E(K,J0)
+  unsigned char *ks;//keystream of the data blocks
+  unsigned long cap;//bytes allocated at ks, a block multiple
+  unsigned long len;//bytes of keystream prepared
+  int ready;
+}gcm_keystream;
+
+int gcm_keystream_init(gcm_keystream *ks, unsigned long max_len);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  allocates a keystream buffer for messages of up to max_len bytes.
+//  returns 0 on success, -1 if it cannot be allocated. release with
+//  gcm_keystream_clear()
+//------------------------------------------------------------------
+
+int gcm_keystream_prepare(gcm_keystream *ks, const gcm_ctxt *gctxt,
+                          const unsigned char *IV, unsigned long len);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  computes E(K,J0) and len bytes of keystream for the 12-byte IV,
+//  meant to run while the sender is idle. a keystream still pending
+//  is wiped first. returns 0 on success, -1 if len exceeds the
+//  buffer or GCM_MAX_PLAINTEXT
+//------------------------------------------------------------------
+
+int aes128gcm_encrypt_precomp(gcm_keystream *ks,
+                              unsigned char *ciphertext,
+                              unsigned char *tag,
+                              const unsigned char *plaintext,
+                              const unsigned long len_p,
+                              const unsigned char *add_data,
+                              const unsigned long len_ad);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  encrypts with the prepared keystream, identical to
+//  aes128gcm_encrypt() under the prepared IV. len_p may be shorter
+//  than the prepared length. the keystream is wiped afterwards.
+//  returns 0 on success, -1 if nothing is prepared or len_p is
+//  longer than the keystream, then the keystream is kept
+//------------------------------------------------------------------
+
+int aes128gcm_decrypt_precomp(gcm_keystream *ks,
+                              unsigned char *plaintext,
+                              const unsigned char *tag,
+                              const unsigned char *ciphertext,
+                              const unsigned long len_c,
+                              const unsigned char *add_data,
+                              const unsigned long len_ad);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  receiving counterpart, the tag is verified before any plaintext
+//  is written. the keystream is wiped afterwards. returns 0 if the
+//  message is authentic, -1 otherwise
+//------------------------------------------------------------------
+
+void gcm_keystream_clear(gcm_keystream *ks);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  wipes and frees the keystream buffer
+//------------------------------------------------------------------
+#endif
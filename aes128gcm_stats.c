@@ -0,0 +1,193 @@
+//-------------------------------------------------------------------
+// FILE: aes128gcm_stats.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  per thread counters behind the GCM_STAT_* hooks. every thread
+//  allocates its counters on its first hook and links them into a
+//  list read by gcm_stats_get(); they are folded into the totals of
+//  exited threads when the thread ends. a thread only writes its own
+//  counters, with relaxed atomic stores, so the hooks take no lock
+//-------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "aes128gcm_stats.h"
+
+#ifdef GCM_STATS
+
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#else
+#define HAVE_TSC 0
+#endif
+
+#define BLK_LEN 16
+//gcm_stats is read as an array of counters
+#define NCOUNTERS (sizeof(gcm_stats)/sizeof(unsigned long long))
+
+//definition of the counters of one thread
+typedef struct stats_slot
+{
+  gcm_stats s;
+  struct stats_slot *prev;
+  struct stats_slot *next;
+}stats_slot;
+
+static pthread_mutex_t slots_lock=PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t slots_once=PTHREAD_ONCE_INIT;
+static pthread_key_t slots_key;
+static stats_slot *slots;//live threads
+static gcm_stats retired;//sum of the exited threads
+static __thread stats_slot *mine;
+
+//------------------------------------------------------------------
+static void bump(unsigned long long *c, unsigned long long v)
+{
+  __atomic_store_n(c, __atomic_load_n(c, __ATOMIC_RELAXED)+v,
+                   __ATOMIC_RELAXED);
+}
+
+//------------------------------------------------------------------
+static void sum_into(gcm_stats *dst, gcm_stats *src)
+{
+  unsigned long long *d=(unsigned long long *)dst;
+  unsigned long long *s=(unsigned long long *)src;
+
+  for(size_t i=0; i<NCOUNTERS; i++)
+    d[i]+=__atomic_load_n(&s[i], __ATOMIC_RELAXED);
+}
+
+//------------------------------------------------------------------
+//thread exit, keeps the counts of the thread
+static void slot_exit(void *arg)
+{
+  stats_slot *sl=(stats_slot *)arg;
+
+  pthread_mutex_lock(&slots_lock);
+  sum_into(&retired, &sl->s);
+  if(sl->prev)
+    sl->prev->next=sl->next;
+  else
+    slots=sl->next;
+  if(sl->next)
+    sl->next->prev=sl->prev;
+  pthread_mutex_unlock(&slots_lock);
+  free(sl);
+}
+
+//------------------------------------------------------------------
+static void slots_init(void)
+{
+  pthread_key_create(&slots_key, slot_exit);
+}
+
+//------------------------------------------------------------------
+//counters of the calling thread, NULL if they cannot be allocated
+static gcm_stats *my_stats(void)
+{
+  if(!mine)
+  {
+    stats_slot *sl;
+
+    pthread_once(&slots_once, slots_init);
+    if(!(sl=calloc(1, sizeof(*sl))))
+      return NULL;
+    pthread_mutex_lock(&slots_lock);
+    sl->next=slots;
+    if(slots)
+      slots->prev=sl;
+    slots=sl;
+    pthread_mutex_unlock(&slots_lock);
+    pthread_setspecific(slots_key, sl);
+    mine=sl;
+  }
+  return &mine->s;
+}
+
+//------------------------------------------------------------------
+uint64_t gcm_stats_now(void)
+{
+#if HAVE_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+//------------------------------------------------------------------
+void gcm_stats_add(int stage, uint64_t start, unsigned long long bytes)
+{
+  uint64_t end=gcm_stats_now();
+  gcm_stats *s=my_stats();
+
+  if(!s)
+    return;
+  bump(&s->calls[stage], 1);
+  bump(&s->blocks[stage], bytes/BLK_LEN);
+  bump(&s->bytes[stage], bytes);
+  bump(&s->cycles[stage], end-start);
+}
+
+//------------------------------------------------------------------
+void gcm_stats_decision(int kind, int id)
+{
+  gcm_stats *s=my_stats();
+
+  if(!s || id<0)
+    return;
+  if(kind==GCM_DECIDE_AES && id<GCM_STATS_BACKENDS)
+    bump(&s->aes_backend[id], 1);
+  else if(kind==GCM_DECIDE_GHASH && id<GCM_STATS_BACKENDS)
+    bump(&s->ghash_backend[id], 1);
+  else if(kind==GCM_DECIDE_PATH && id<GCM_NPATHS)
+    bump(&s->path[id], 1);
+}
+
+//------------------------------------------------------------------
+int gcm_stats_get(gcm_stats *stats)
+{
+  memset(stats, 0, sizeof(*stats));
+  pthread_mutex_lock(&slots_lock);
+  sum_into(stats, &retired);
+  for(stats_slot *sl=slots; sl; sl=sl->next)
+    sum_into(stats, &sl->s);
+  pthread_mutex_unlock(&slots_lock);
+  return 0;
+}
+
+//------------------------------------------------------------------
+void gcm_stats_reset(void)
+{
+  pthread_mutex_lock(&slots_lock);
+  memset(&retired, 0, sizeof(retired));
+  for(stats_slot *sl=slots; sl; sl=sl->next)
+  {
+    unsigned long long *c=(unsigned long long *)&sl->s;
+
+    for(size_t i=0; i<NCOUNTERS; i++)
+      __atomic_store_n(&c[i], 0, __ATOMIC_RELAXED);
+  }
+  pthread_mutex_unlock(&slots_lock);
+}
+
+#else
+
+//built without GCM_STATS, there are no counters
+int gcm_stats_get(gcm_stats *stats)
+{
+  memset(stats, 0, sizeof(*stats));
+  return -1;
+}
+
+void gcm_stats_reset(void)
+{
+}
+
+#endif
+
+//end of file
@@ -0,0 +1,107 @@
+#ifndef AES128GCM_STATS_H
+#define AES128GCM_STATS_H
+//-------------------------------------------------------------------
+// FILE: aes128gcm_stats.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  hot path instrumentation. with -DGCM_STATS every stage of GCM
+//  (key setup, counter mode, GHASH, tag, stitched loops) counts its
+//  calls, blocks, bytes and TSC cycles, and the backend and single
+//  pass loop decisions are counted too. counters live per thread and
+//  are summed by gcm_stats_get(). without GCM_STATS the GCM_STAT_*
+//  hooks expand to nothing and gcm_stats_get() reports that no
+//  counters exist
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+
+//instrumented stages
+enum
+{
+  GCM_STAGE_KEY=0, //gcm_init_key(), round keys, H and GHASH table
+  GCM_STAGE_CTR, //aes128e_ctr32()
+  GCM_STAGE_GHASH, //gcm_ghash()
+  GCM_STAGE_TAG, //gcm_final(), contains the GHASH of its last blocks
+  GCM_STAGE_STITCH, //stitched counter mode and GHASH loops
+  GCM_NSTAGES
+};
+
+//single pass loops picked for whole blocks by gcm_update()
+enum
+{
+  GCM_PATH_STITCH_VAES=0, //gcm_stitch_vaes()
+  GCM_PATH_STITCH_AESNI, //gcm_stitch_aesni()
+  GCM_PATH_GENERIC, //aes128e_ctr32() then gcm_ghash()
+  GCM_NPATHS
+};
+
+//backend ids counted, AES128E_* and GHASH_* are below
+#define GCM_STATS_BACKENDS 8
+
+//definition of the counters
+typedef struct
+{
+  unsigned long long calls[GCM_NSTAGES];
+  unsigned long long blocks[GCM_NSTAGES];//16-byte blocks processed
+  unsigned long long bytes[GCM_NSTAGES];
+  unsigned long long cycles[GCM_NSTAGES];//TSC cycles inside the stage
+  unsigned long long aes_backend[GCM_STATS_BACKENDS];//selections
+  unsigned long long ghash_backend[GCM_STATS_BACKENDS];//selections
+  unsigned long long path[GCM_NPATHS];//runs of each single pass loop
+}gcm_stats;
+
+int gcm_stats_get(gcm_stats *stats);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  sums the counters of all threads, live and exited, into stats.
+//  returns 0, or -1 with stats zeroed when built without GCM_STATS
+//------------------------------------------------------------------
+
+void gcm_stats_reset(void);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  zeroes the counters of all threads. increments racing with the
+//  reset may survive it
+//------------------------------------------------------------------
+
+#ifdef GCM_STATS
+
+//kinds of decisions, internal
+enum
+{
+  GCM_DECIDE_AES=0,
+  GCM_DECIDE_GHASH,
+  GCM_DECIDE_PATH
+};
+
+uint64_t gcm_stats_now(void);
+void gcm_stats_add(int stage, uint64_t start, unsigned long long bytes);
+void gcm_stats_decision(int kind, int id);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  used by the hooks below only. gcm_stats_add() charges one call,
+//  bytes (and bytes/16 blocks) and the cycles since start to stage,
+//  gcm_stats_decision() counts backend or loop id of a decision kind
+//------------------------------------------------------------------
+
+#define GCM_STAT_BEGIN(t) uint64_t t=gcm_stats_now()
+#define GCM_STAT_END(t, stage, bytes) \
+        gcm_stats_add((stage), (t), (unsigned long long)(bytes))
+#define GCM_STAT_AES(id) gcm_stats_decision(GCM_DECIDE_AES, (id))
+#define GCM_STAT_GHASH(id) gcm_stats_decision(GCM_DECIDE_GHASH, (id))
+#define GCM_STAT_PATH(id) gcm_stats_decision(GCM_DECIDE_PATH, (id))
+
+#else
+
+//the statement hooks stay statements, so they may form the body of
+//an if
+#define GCM_STAT_BEGIN(t)
+#define GCM_STAT_END(t, stage, bytes) ((void)0)
+#define GCM_STAT_AES(id) ((void)0)
+#define GCM_STAT_GHASH(id) ((void)0)
+#define GCM_STAT_PATH(id) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,1743 @@
+//-------------------------------------------------------------------
+// FILE: aes128gcm_test.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  differential tests of every compiled-in path against a reference
+//  model built only from aes128e() and gmul_128(): the AES and GHASH
+//  backends, one shot, streaming, batch, scatter-gather, GMAC,
+//  multi-threaded GCM, bulk key setup, precompute tiers, the record
+//  engine and the IV allocator, as well as the counter wrap of inc32
+//  and empty inputs. known answers come from the GCM specification
+//  and, with -v, from the NIST CAVP files (gcmEncryptExtIV128.rsp,
+//  gcmDecrypt128.rsp, ...) of a directory, which must hold at least
+//  one usable case
+//
+//  usage: aes128gcm_test [-v vector_dir] [-s seed] [-n rounds]
+//-------------------------------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "aes128e.h"
+#include "aes128e_impl.h"
+#include "aes128gcm.h"
+#include "aes128gcm_tier.h"
+#include "aes128gcm_impl.h"
+#include "aes128gcm_mt.h"
+#include "aes128gcm_batch.h"
+#include "aes128gcm_chunk.h"
+#include "aes128gcm_precomp.h"
+#include "aes128gcm_keycache.h"
+#include "aes128gcm_iov.h"
+#include "aes128gcm_stats.h"
+#include "aes128gcm_engine.h"
+#include "aes128gcm_nonce.h"
+
+#define BLK_LEN 16
+#define NAES 5
+#define NGHASH 6
+#define MAX_MSG 1024//longest random message of the small tests
+#define MAX_BATCH 100
+#define MAX_LINE 4096
+#define MAX_SEG 12//most segments of a scatter-gather list
+#define ENG_PRODUCERS 4
+#define ENG_FLOWS 8//two per producer
+#define ENG_JOBS 64//records per flow
+#define ENG_LEN 300
+#define NONCE_THREADS 4
+#define NONCE_LIMIT 20011
+#define MAX_KEYS 100//keys of one bulk key setup
+
+static const char *aes_names[NAES]={"ref", "ttable", "aesni", "bitslice",
+                                     "vaes"};
+static const char *ghash_names[NGHASH]={"ref", "tab4", "tab8", "clmul",
+                                         "vclmul", "ct"};
+
+static unsigned long checks, failures;
+static unsigned long long rng_state;
+
+#define CHECK(cond, ...) \
+  do \
+  { \
+    checks++; \
+    if(!(cond)) \
+    { \
+      failures++; \
+      if(failures<=20) \
+      { \
+        printf("FAIL %s:%d: ", __func__, __LINE__); \
+        printf(__VA_ARGS__); \
+        printf("\n"); \
+      } \
+    } \
+  }while(0)
+
+//------------------------------------------------------------------
+//xorshift64*, reproducible across hosts for a given seed
+static unsigned long long rnd(void)
+{
+  rng_state^=rng_state >> 12;
+  rng_state^=rng_state << 25;
+  rng_state^=rng_state >> 27;
+  return rng_state*0x2545f4914f6cdd1dULL;
+}
+
+//------------------------------------------------------------------
+static unsigned long rnd_len(unsigned long max)
+{
+  //a third of the lengths are block multiples, the rest arbitrary
+  unsigned long len=(unsigned long)(rnd()%(max+1));
+
+  if(!(rnd()%3))
+    len-=len%BLK_LEN;
+  return len;
+}
+
+//------------------------------------------------------------------
+static void rnd_bytes(unsigned char *buf, unsigned long len)
+{
+  for(unsigned long i=0; i<len; i++)
+    buf[i]=(unsigned char)(rnd() >> 56);
+}
+
+//------------------------------------------------------------------
+//reference inc32: the last 32 bits, big endian, wrap modulo 2^32
+static void ref_inc32(unsigned char *ctr)
+{
+  for(int i=15; i>=12; i--)
+    if(++ctr[i])
+      break;
+}
+
+//------------------------------------------------------------------
+//reference GHASH of len bytes of X, a trailing partial block padded
+static void ref_ghash(const unsigned char *H, unsigned char *Y,
+                      const unsigned char *X, unsigned long len)
+{
+  unsigned char blk[BLK_LEN], t[BLK_LEN];
+
+  for(unsigned long off=0; off<len; off+=BLK_LEN)
+  {
+    unsigned long n= (len-off<BLK_LEN) ? len-off : BLK_LEN;
+
+    memset(blk, 0, BLK_LEN);
+    memcpy(blk, &X[off], n);
+    for(int i=0; i<BLK_LEN; i++)
+      t[i]=Y[i]^blk[i];
+    gmul_128(t, H, Y);
+  }
+}
+
+//------------------------------------------------------------------
+//reference counter mode over len bytes from counter block ctr
+static void ref_ctr(const unsigned char *key, unsigned char *out,
+                    const unsigned char *in, unsigned long len,
+                    const unsigned char *ctr0)
+{
+  unsigned char ctr[BLK_LEN], ks[BLK_LEN];
+
+  memcpy(ctr, ctr0, BLK_LEN);
+  for(unsigned long off=0; off<len; off+=BLK_LEN)
+  {
+    unsigned long n= (len-off<BLK_LEN) ? len-off : BLK_LEN;
+
+    aes128e(ks, ctr, key);
+    for(unsigned long i=0; i<n; i++)
+      out[off+i]=in[off+i]^ks[i];
+    ref_inc32(ctr);
+  }
+}
+
+//------------------------------------------------------------------
+//reference GCM with a 12-byte IV, lengths in bytes
+static void ref_gcm(unsigned char *ct, unsigned char *tag,
+                    const unsigned char *key, const unsigned char *IV,
+                    const unsigned char *pt, unsigned long len,
+                    const unsigned char *aad, unsigned long len_ad)
+{
+  unsigned char H[BLK_LEN], J0[BLK_LEN], ctr[BLK_LEN], Y[BLK_LEN];
+  unsigned char zero[BLK_LEN]={0}, lens[BLK_LEN];
+  unsigned long long bits_a=8ULL*len_ad, bits_c=8ULL*len;
+
+  aes128e(H, zero, key);
+  memcpy(J0, IV, 12);
+  J0[12]=J0[13]=J0[14]=0;
+  J0[15]=1;
+  memcpy(ctr, J0, BLK_LEN);
+  ref_inc32(ctr);
+  ref_ctr(key, ct, pt, len, ctr);
+
+  memset(Y, 0, BLK_LEN);
+  ref_ghash(H, Y, aad, len_ad);
+  ref_ghash(H, Y, ct, len);
+  for(int i=7; i>=0; i--, bits_a>>=8, bits_c>>=8)
+  {
+    lens[i]=(unsigned char)bits_a;
+    lens[8+i]=(unsigned char)bits_c;
+  }
+  ref_ghash(H, Y, lens, BLK_LEN);
+  aes128e(tag, J0, key);
+  for(int i=0; i<BLK_LEN; i++)
+    tag[i]^=Y[i];
+}
+
+//------------------------------------------------------------------
+//key context with the given backends, returns -1 if one of them is
+//not available on this host
+static int ctxt_init(gcm_ctxt *g, const unsigned char *key, int a, int h)
+{
+  if(gcm_init_key(g, key) || aes128e_set_backend(&g->kctxt, a) ||
+     gcm_set_ghash(g, h))
+  {
+    gcm_clear_key(g);
+    return -1;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------
+static void test_aes_blocks(void)
+{
+  unsigned char key[NAES][BLK_LEN], p[40*BLK_LEN], c[40*BLK_LEN];
+  unsigned char r[BLK_LEN], ctr[BLK_LEN];
+  key_ctxt kc[NAES];
+  const key_ctxt *kp[40];
+
+  for(int a=0; a<NAES; a++)
+  {
+    rnd_bytes(key[a], BLK_LEN);
+    aes128e_set_key(&kc[a], key[a]);
+    if(aes128e_set_backend(&kc[a], a))
+    {
+      printf("aes %s: not available, skipped\n", aes_names[a]);
+      aes128e_set_backend(&kc[a], AES128E_REF);
+      continue;
+    }
+    for(unsigned long n=0; n<=40; n+=1+n/4)
+    {
+      rnd_bytes(p, n*BLK_LEN);
+      aes128e_blocks(&kc[a], c, p, n);
+      for(unsigned long i=0; i<n; i++)
+      {
+        aes128e(r, &p[i*BLK_LEN], key[a]);
+        CHECK(!memcmp(r, &c[i*BLK_LEN], BLK_LEN),
+              "aes %s block %lu of %lu", aes_names[a], i, n);
+      }
+    }
+
+    //the last 32 bits of the counter wrap, the rest stays
+    for(int w=0; w<6; w++)
+    {
+      static const unsigned long starts[6]={0xffffffffUL, 0xfffffffeUL,
+        0xfffffff8UL, 0xffffffe0UL, 0xffffffdbUL, 0x7fffffffUL};
+      unsigned char ref[37*BLK_LEN], next[BLK_LEN];
+
+      rnd_bytes(ctr, 12);
+      for(int i=0; i<4; i++)
+        ctr[12+i]=(unsigned char)(starts[w] >> (24-8*i));
+      rnd_bytes(p, 37*BLK_LEN);
+      ref_ctr(key[a], ref, p, 37*BLK_LEN, ctr);
+      memcpy(next, ctr, BLK_LEN);
+      for(int i=0; i<37; i++)
+        ref_inc32(next);
+      aes128e_ctr32(&kc[a], c, p, ctr, 37);
+      CHECK(!memcmp(ref, c, 37*BLK_LEN) && !memcmp(ctr, next, BLK_LEN),
+            "aes %s ctr32 wrap from %08lx", aes_names[a], starts[w]);
+    }
+  }
+
+  //multi-key blocks, once with mixed backends and once with one
+  for(int round=0; round<2*NAES; round++)
+  {
+    unsigned long n=1+rnd()%40;
+
+    for(unsigned long i=0; i<n; i++)
+      kp[i]= (round<NAES) ? &kc[rnd()%NAES] : &kc[round-NAES];
+    rnd_bytes(p, n*BLK_LEN);
+    aes128e_blocks_multi(kp, c, p, n);
+    for(unsigned long i=0; i<n; i++)
+    {
+      aes128e(r, &p[i*BLK_LEN], key[kp[i]-kc]);
+      CHECK(!memcmp(r, &c[i*BLK_LEN], BLK_LEN), "aes multi block %lu", i);
+    }
+  }
+  for(int a=0; a<NAES; a++)
+    aes128e_clear_key(&kc[a]);
+}
+
+//------------------------------------------------------------------
+static void test_ghash(void)
+{
+  unsigned char key[BLK_LEN], X[33*BLK_LEN], Y[BLK_LEN], R[BLK_LEN];
+  gcm_ctxt g;
+
+  for(int h=0; h<NGHASH; h++)
+  {
+    rnd_bytes(key, BLK_LEN);
+    if(ctxt_init(&g, key, AES128E_REF, h))
+    {
+      printf("ghash %s: not available, skipped\n", ghash_names[h]);
+      continue;
+    }
+    for(unsigned long n=0; n<=33; n++)
+    {
+      rnd_bytes(X, n*BLK_LEN);
+      rnd_bytes(Y, BLK_LEN);
+      memcpy(R, Y, BLK_LEN);
+      gcm_ghash(&g, Y, X, n);
+      ref_ghash(g.H, R, X, n*BLK_LEN);
+      CHECK(!memcmp(R, Y, BLK_LEN), "ghash %s over %lu blocks",
+            ghash_names[h], n);
+    }
+    gcm_clear_key(&g);
+  }
+}
+
+//------------------------------------------------------------------
+//one shot and streaming encryption and decryption of one message
+//under the key context g against the reference ciphertext and tag
+static void check_message(const gcm_ctxt *g, const char *what,
+                          const unsigned char *IV,
+                          const unsigned char *pt, unsigned long len,
+                          const unsigned char *aad, unsigned long len_ad,
+                          const unsigned char *ref_ct,
+                          const unsigned char *ref_tag)
+{
+  unsigned char *ct=malloc(len+1), *dec=malloc(len+1);
+  unsigned char tag[BLK_LEN], bad[BLK_LEN];
+  gcm_stream st;
+  unsigned long off;
+
+  CHECK(!aes128gcm_encrypt(g, ct, tag, IV, pt, len, aad, len_ad),
+        "%s encrypt len %lu", what, len);
+  CHECK(!memcmp(ct, ref_ct, len) && !memcmp(tag, ref_tag, BLK_LEN),
+        "%s encrypt len %lu len_ad %lu", what, len, len_ad);
+
+  for(int mode=GCM_VERIFY_FIRST; mode<=GCM_FUSED; mode++)
+  {
+    memset(dec, 0x5a, len);
+    CHECK(!aes128gcm_decrypt(g, dec, ref_tag, IV, ref_ct, len, aad, len_ad,
+                             mode) && !memcmp(dec, pt, len),
+          "%s decrypt mode %d len %lu", what, mode, len);
+
+    memcpy(bad, ref_tag, BLK_LEN);
+    bad[rnd()%BLK_LEN]^=(unsigned char)(1 << (rnd()%8));
+    memset(dec, 0x5a, len);
+    CHECK(aes128gcm_decrypt(g, dec, bad, IV, ref_ct, len, aad, len_ad,
+                            mode), "%s forged tag accepted", what);
+    for(off=0; off<len && (dec[off]==0x5a || mode==GCM_FUSED); off++);
+    CHECK(off==len, "%s plaintext released on forgery", what);
+  }
+
+  //streaming with random chunk sizes, in place for decryption
+  gcm_init(&st, g, IV);
+  for(off=0; off<len_ad; )
+  {
+    unsigned long n=rnd()%(len_ad-off+1);
+
+    CHECK(!gcm_update_aad(&st, &aad[off], n), "%s update_aad", what);
+    off+=n;
+  }
+  for(off=0; off<len; )
+  {
+    unsigned long n=rnd()%(len-off+1);
+
+    CHECK(!gcm_update(&st, &ct[off], &pt[off], n), "%s update", what);
+    off+=n;
+  }
+  gcm_final(&st, tag);
+  CHECK(!memcmp(ct, ref_ct, len) && !memcmp(tag, ref_tag, BLK_LEN),
+        "%s stream encrypt len %lu len_ad %lu", what, len, len_ad);
+
+  memcpy(dec, ref_ct, len);
+  gcm_init(&st, g, IV);
+  CHECK(!gcm_update_aad(&st, aad, len_ad), "%s update_aad", what);
+  for(off=0; off<len; )
+  {
+    unsigned long n=1+rnd()%(len-off+BLK_LEN);
+
+    n= (n>len-off) ? len-off : n;
+    CHECK(!gcm_update_decrypt(&st, &dec[off], &dec[off], n),
+          "%s update_decrypt", what);
+    off+=n;
+  }
+  CHECK(!gcm_final_verify(&st, ref_tag) && !memcmp(dec, pt, len),
+        "%s stream decrypt len %lu", what, len);
+  free(ct);
+  free(dec);
+}
+
+//------------------------------------------------------------------
+static void test_messages(unsigned long rounds)
+{
+  unsigned char key[BLK_LEN], IV[12], tag[BLK_LEN];
+  unsigned char pt[MAX_MSG], ct[MAX_MSG], aad[MAX_MSG];
+  char what[64];
+  gcm_ctxt g;
+
+  for(unsigned long r=0; r<rounds; r++)
+  {
+    unsigned long len=rnd_len(r%4 ? 160 : MAX_MSG);
+    unsigned long len_ad=rnd_len(r%3 ? 40 : MAX_MSG/2);
+
+    rnd_bytes(key, BLK_LEN);
+    rnd_bytes(IV, 12);
+    rnd_bytes(pt, len);
+    rnd_bytes(aad, len_ad);
+    ref_gcm(ct, tag, key, IV, pt, len, aad, len_ad);
+    for(int a=0; a<NAES; a++)
+      for(int h=0; h<NGHASH; h++)
+      {
+        if(ctxt_init(&g, key, a, h))
+          continue;
+        sprintf(what, "%s/%s", aes_names[a], ghash_names[h]);
+        check_message(&g, what, IV, pt, len, aad, len_ad, ct, tag);
+        gcm_clear_key(&g);
+      }
+  }
+}
+
+//------------------------------------------------------------------
+//segments starting at counter blocks whose last 32 bits wrap
+static void test_segment_wrap(void)
+{
+  unsigned char key[BLK_LEN], ctr[BLK_LEN], Y[BLK_LEN], R[BLK_LEN];
+  unsigned char in[75*BLK_LEN], out[75*BLK_LEN], ref[75*BLK_LEN];
+  gcm_ctxt g;
+
+  rnd_bytes(key, BLK_LEN);
+  for(int a=0; a<NAES; a++)
+    for(int h=0; h<NGHASH; h++)
+    {
+      if(ctxt_init(&g, key, a, h))
+        continue;
+      for(int decrypt=0; decrypt<2; decrypt++)
+      {
+        unsigned long len=rnd_len(sizeof(in));
+
+        rnd_bytes(ctr, 12);
+        memset(&ctr[12], 0xff, 4);
+        ctr[15]-=(unsigned char)(rnd()%40);
+        rnd_bytes(in, len);
+        ref_ctr(key, ref, in, len, ctr);
+        gcm_segment(&g, out, in, len, ctr, Y, decrypt);
+        memset(R, 0, BLK_LEN);
+        ref_ghash(g.H, R, decrypt ? in : ref, len);
+        CHECK(!memcmp(out, ref, len) && !memcmp(Y, R, BLK_LEN),
+              "%s/%s segment wrap len %lu decrypt %d", aes_names[a],
+              ghash_names[h], len, decrypt);
+      }
+      gcm_clear_key(&g);
+    }
+}
+
+//------------------------------------------------------------------
+static void test_batch(unsigned long rounds)
+{
+  static unsigned char pt[MAX_BATCH][300], ct[MAX_BATCH][300];
+  static unsigned char out[MAX_BATCH][300], aad[MAX_BATCH][64];
+  unsigned char key[NAES*NGHASH][BLK_LEN], IV[MAX_BATCH][12];
+  unsigned char tag[MAX_BATCH][BLK_LEN];
+  gcm_ctxt g[NAES*NGHASH];
+  int ng=0, key_of[NAES*NGHASH];
+  gcm_job jobs[MAX_BATCH];
+
+  for(int a=0; a<NAES; a++)
+    for(int h=0; h<NGHASH; h++)
+    {
+      rnd_bytes(key[ng], BLK_LEN);
+      if(!ctxt_init(&g[ng], key[ng], a, h))
+        key_of[ng]=ng, ng++;
+    }
+
+  for(unsigned long r=0; r<rounds; r++)
+  {
+    unsigned int njobs=1+rnd()%MAX_BATCH;
+    //every other round all jobs share the default context
+    int shared= (r&1) ? (int)(rnd()%ng) : -1;
+    int failed=0, expect=0;
+
+    for(unsigned int j=0; j<njobs; j++)
+    {
+      int k= (shared>=0) ? shared : (int)(rnd()%ng);
+
+      jobs[j].gctxt=&g[k];
+      jobs[j].len=rnd_len(sizeof(pt[j]));
+      jobs[j].len_ad=rnd_len(sizeof(aad[j]));
+      rnd_bytes(pt[j], jobs[j].len);
+      rnd_bytes(aad[j], jobs[j].len_ad);
+      rnd_bytes(IV[j], 12);
+      jobs[j].IV=IV[j];
+      jobs[j].add_data=aad[j];
+      //half of the jobs encrypt in place
+      jobs[j].in= (rnd()&1) ? pt[j] : out[j];
+      jobs[j].out=out[j];
+      memcpy(out[j], pt[j], jobs[j].len);
+      ref_gcm(ct[j], tag[j], key[key_of[k]], IV[j], pt[j], jobs[j].len,
+              aad[j], jobs[j].len_ad);
+    }
+    CHECK(!aes128gcm_encrypt_batch(jobs, njobs), "batch encrypt");
+    for(unsigned int j=0; j<njobs; j++)
+      CHECK(!jobs[j].status && !memcmp(jobs[j].out, ct[j], jobs[j].len) &&
+            !memcmp(jobs[j].tag, tag[j], BLK_LEN),
+            "batch encrypt job %u of %u len %lu", j, njobs, jobs[j].len);
+
+    //decrypt in place with a few forged tags
+    for(unsigned int j=0; j<njobs; j++)
+    {
+      memcpy(out[j], ct[j], jobs[j].len);
+      jobs[j].in=jobs[j].out=out[j];
+      memcpy(jobs[j].tag, tag[j], BLK_LEN);
+      if(!(rnd()%5))
+      {
+        jobs[j].tag[rnd()%BLK_LEN]^=0x80;
+        expect++;
+      }
+    }
+    failed=aes128gcm_decrypt_batch(jobs, njobs);
+    CHECK(failed==expect, "batch decrypt %d failed, %d forged", failed,
+          expect);
+    for(unsigned int j=0; j<njobs; j++)
+    {
+      int forged=memcmp(jobs[j].tag, tag[j], BLK_LEN)!=0;
+
+      CHECK(jobs[j].status==(forged ? -1 : 0) &&
+            !memcmp(out[j], forged ? ct[j] : pt[j], jobs[j].len),
+            "batch decrypt job %u forged %d", j, forged);
+    }
+  }
+  for(int k=0; k<ng; k++)
+    gcm_clear_key(&g[k]);
+}
+
+//------------------------------------------------------------------
+static void test_mt(void)
+{
+  unsigned long lens[]={3*GCM_MT_MIN_SEGMENT+4093, 5*GCM_MT_MIN_SEGMENT,
+                        GCM_MT_MIN_SEGMENT/2+1};
+  unsigned char key[BLK_LEN], IV[12], tag[BLK_LEN], ref_tag[BLK_LEN];
+  unsigned char aad[77];
+  gcm_ctxt g;
+
+  for(unsigned int i=0; i<sizeof(lens)/sizeof(lens[0]); i++)
+  {
+    unsigned long len=lens[i];
+    unsigned char *pt=malloc(len), *ct=malloc(len), *out=malloc(len);
+
+    rnd_bytes(key, BLK_LEN);
+    rnd_bytes(IV, 12);
+    rnd_bytes(aad, sizeof(aad));
+    rnd_bytes(pt, len);
+    ref_gcm(ct, ref_tag, key, IV, pt, len, aad, sizeof(aad));
+    for(int a=0; a<NAES; a++)
+      for(int h=0; h<NGHASH; h++)
+      {
+        unsigned int nthreads=1+(unsigned int)(rnd()%8);
+
+        //the reference GHASH is too slow for megabytes
+        if((h==GHASH_REF && i<2) || ctxt_init(&g, key, a, h))
+          continue;
+        CHECK(!aes128gcm_encrypt_mt(&g, out, tag, IV, pt, len, aad,
+                                    sizeof(aad), nthreads) &&
+              !memcmp(out, ct, len) && !memcmp(tag, ref_tag, BLK_LEN),
+              "%s/%s mt encrypt len %lu threads %u", aes_names[a],
+              ghash_names[h], len, nthreads);
+        CHECK(!aes128gcm_decrypt_mt(&g, out, ref_tag, IV, ct, len, aad,
+                                    sizeof(aad), nthreads) &&
+              !memcmp(out, pt, len), "%s/%s mt decrypt len %lu",
+              aes_names[a], ghash_names[h], len);
+        tag[0]=ref_tag[0]^1;
+        CHECK(aes128gcm_decrypt_mt(&g, out, tag, IV, ct, len, aad,
+                                   sizeof(aad), nthreads),
+              "%s/%s mt forged tag accepted", aes_names[a],
+              ghash_names[h]);
+        gcm_clear_key(&g);
+      }
+    free(pt);
+    free(ct);
+    free(out);
+  }
+}
+
+//------------------------------------------------------------------
+//precomputed keystreams, shorter payloads than prepared and reuse
+static void test_precomp(unsigned long rounds)
+{
+  unsigned char key[BLK_LEN], IV[12], tag[BLK_LEN], ref_tag[BLK_LEN];
+  unsigned char pt[MAX_MSG], ct[MAX_MSG], out[MAX_MSG], aad[64];
+  gcm_keystream ks;
+  gcm_ctxt g;
+
+  CHECK(!gcm_keystream_init(&ks, MAX_MSG), "keystream init");
+  for(unsigned long r=0; r<rounds; r++)
+  {
+    unsigned long len=rnd_len(MAX_MSG), len_ad=rnd_len(sizeof(aad));
+    unsigned long prep=len+rnd()%(MAX_MSG-len+1);
+
+    rnd_bytes(key, BLK_LEN);
+    rnd_bytes(IV, 12);
+    rnd_bytes(pt, len);
+    rnd_bytes(aad, len_ad);
+    ref_gcm(ct, ref_tag, key, IV, pt, len, aad, len_ad);
+    if(ctxt_init(&g, key, (int)(rnd()%NAES), (int)(rnd()%NGHASH)))
+      gcm_init_key(&g, key);
+
+    CHECK(!gcm_keystream_prepare(&ks, &g, IV, prep) &&
+          !aes128gcm_encrypt_precomp(&ks, out, tag, pt, len, aad, len_ad) &&
+          !memcmp(out, ct, len) && !memcmp(tag, ref_tag, BLK_LEN),
+          "precomp encrypt len %lu prepared %lu", len, prep);
+    CHECK(aes128gcm_encrypt_precomp(&ks, out, tag, pt, len, aad, len_ad),
+          "precomp keystream used twice");
+
+    gcm_keystream_prepare(&ks, &g, IV, prep);
+    tag[0]=ref_tag[0]^(unsigned char)(r&1);
+    memset(out, 0x5a, len);
+    if(r&1)
+      CHECK(aes128gcm_decrypt_precomp(&ks, out, tag, ct, len, aad, len_ad) &&
+            (!len || out[0]==0x5a), "precomp forged tag accepted");
+    else
+      CHECK(!aes128gcm_decrypt_precomp(&ks, out, tag, ct, len, aad, len_ad) &&
+            !memcmp(out, pt, len), "precomp decrypt len %lu", len);
+    CHECK(!ks.ready, "precomp keystream kept after use");
+    gcm_clear_key(&g);
+  }
+  CHECK(gcm_keystream_prepare(&ks, &g, IV, MAX_MSG+1), "precomp overlong");
+  gcm_keystream_clear(&ks);
+}
+
+//------------------------------------------------------------------
+//cuts len bytes at buf into at most MAX_SEG segments of random
+//length, empty ones included. returns the number of segments
+static unsigned int rnd_split(struct iovec *iov, unsigned char *buf,
+                              unsigned long len)
+{
+  unsigned int n=1+(unsigned int)(rnd()%MAX_SEG);
+
+  for(unsigned int i=0; i<n; i++)
+  {
+    unsigned long seg= (i==n-1) ? len : rnd_len(len);
+
+    iov[i].iov_base=buf;
+    iov[i].iov_len=seg;
+    buf+=seg;
+    len-=seg;
+  }
+  return n;
+}
+
+//------------------------------------------------------------------
+//scatter-gather lists split at random offsets against the flat
+//reference, in place and with differently split output lists
+static void test_iov(unsigned long rounds)
+{
+  unsigned char key[BLK_LEN], IV[12], tag[BLK_LEN], ref_tag[BLK_LEN];
+  unsigned char pt[MAX_MSG], ct[MAX_MSG], buf[MAX_MSG], aad[96];
+  struct iovec in[MAX_SEG], out[MAX_SEG], ad[MAX_SEG];
+  unsigned int nin, nout, nad;
+  gcm_ctxt g;
+
+  for(unsigned long r=0; r<rounds; r++)
+  {
+    unsigned long len=rnd_len(MAX_MSG), len_ad=rnd_len(sizeof(aad));
+    int mode= (r&1) ? GCM_FUSED : GCM_VERIFY_FIRST;
+
+    rnd_bytes(key, BLK_LEN);
+    rnd_bytes(IV, 12);
+    rnd_bytes(pt, len);
+    rnd_bytes(aad, len_ad);
+    ref_gcm(ct, ref_tag, key, IV, pt, len, aad, len_ad);
+    if(ctxt_init(&g, key, (int)(rnd()%NAES), (int)(rnd()%NGHASH)))
+      gcm_init_key(&g, key);
+
+    nin=rnd_split(in, pt, len);
+    nout=rnd_split(out, buf, len);
+    nad=rnd_split(ad, aad, len_ad);
+    CHECK(!aes128gcm_encrypt_iov(&g, out, nout, tag, IV, in, nin, ad, nad) &&
+          !memcmp(buf, ct, len) && !memcmp(tag, ref_tag, BLK_LEN),
+          "iov encrypt len %lu segments %u/%u", len, nin, nout);
+
+    //in place over the same list
+    memcpy(buf, ct, len);
+    CHECK(!aes128gcm_decrypt_iov(&g, out, nout, ref_tag, IV, out, nout,
+                                 ad, nad, mode) &&
+          !memcmp(buf, pt, len), "iov decrypt in place len %lu mode %d",
+          len, mode);
+
+    memcpy(buf, ct, len);
+    tag[0]=ref_tag[0]^1;
+    nin=rnd_split(in, ct, len);
+    CHECK(aes128gcm_decrypt_iov(&g, out, nout, tag, IV, in, nin,
+                                ad, nad, mode) &&
+          (mode==GCM_FUSED || !memcmp(buf, ct, len)),
+          "iov forged tag accepted mode %d", mode);
+    if(len)
+    {
+      out[0].iov_base=buf;
+      out[0].iov_len=len-1;
+      CHECK(aes128gcm_encrypt_iov(&g, out, 1, tag, IV, in, nin, ad, nad),
+            "iov short output accepted");
+    }
+    gcm_clear_key(&g);
+  }
+}
+
+//------------------------------------------------------------------
+static void *stats_worker(void *arg)
+{
+  unsigned char key[BLK_LEN]={1}, IV[12]={2}, tag[BLK_LEN];
+  unsigned char *buf=(unsigned char *)arg;
+  gcm_ctxt g;
+
+  gcm_init_key(&g, key);
+  aes128gcm_encrypt(&g, buf, tag, IV, buf, 4096, NULL, 0);
+  gcm_clear_key(&g);
+  return NULL;
+}
+
+//------------------------------------------------------------------
+//counters of exited threads, only with -DGCM_STATS
+static void test_stats(void)
+{
+  static unsigned char buf[2][4096];
+  unsigned long long paths=0, aes=0, ghash=0;
+  pthread_t th[2];
+  gcm_stats s;
+
+  if(gcm_stats_get(&s))
+  {
+    printf("stats: built without GCM_STATS, skipped\n");
+    return;
+  }
+  gcm_stats_reset();
+  for(int i=0; i<2; i++)
+    pthread_create(&th[i], NULL, stats_worker, buf[i]);
+  for(int i=0; i<2; i++)
+    pthread_join(th[i], NULL);
+  gcm_stats_get(&s);
+
+  for(int i=0; i<GCM_NPATHS; i++)
+    paths+=s.path[i];
+  for(int i=0; i<GCM_STATS_BACKENDS; i++)
+  {
+    aes+=s.aes_backend[i];
+    ghash+=s.ghash_backend[i];
+  }
+  CHECK(s.calls[GCM_STAGE_KEY]==2 && s.calls[GCM_STAGE_TAG]==2,
+        "stats key %llu tag %llu calls", s.calls[GCM_STAGE_KEY],
+        s.calls[GCM_STAGE_TAG]);
+  CHECK(s.bytes[GCM_STAGE_CTR]+s.bytes[GCM_STAGE_STITCH]==2*4096,
+        "stats ctr %llu stitch %llu bytes", s.bytes[GCM_STAGE_CTR],
+        s.bytes[GCM_STAGE_STITCH]);
+  CHECK(s.blocks[GCM_STAGE_GHASH]*BLK_LEN==s.bytes[GCM_STAGE_GHASH],
+        "stats ghash blocks");
+  CHECK(paths>=2 && aes==2 && ghash==2, "stats decisions %llu %llu %llu",
+        paths, aes, ghash);
+}
+
+//------------------------------------------------------------------
+//GMAC is GCM of an empty plaintext with the data as AAD
+static void test_gmac(unsigned long rounds)
+{
+  unsigned char key[BLK_LEN], IV[12], tag[BLK_LEN], ref_tag[BLK_LEN];
+  unsigned char data[4*MAX_MSG], none[1];
+  gcm_stream st;
+  gcm_ctxt g;
+
+  for(unsigned long r=0; r<rounds; r++)
+  {
+    unsigned long len=rnd_len(sizeof(data)), done=0;
+
+    rnd_bytes(key, BLK_LEN);
+    rnd_bytes(IV, 12);
+    rnd_bytes(data, len);
+    ref_gcm(none, ref_tag, key, IV, none, 0, data, len);
+    if(ctxt_init(&g, key, (int)(rnd()%NAES), (int)(rnd()%NGHASH)))
+      gcm_init_key(&g, key);
+
+    CHECK(!aes128gmac(&g, tag, IV, data, len) &&
+          !memcmp(tag, ref_tag, BLK_LEN), "gmac len %lu", len);
+    CHECK(!aes128gmac_verify(&g, ref_tag, IV, data, len),
+          "gmac verify len %lu", len);
+
+    gmac_init(&st, &g, IV);
+    while(done<len)
+    {
+      unsigned long n=rnd_len(len-done);
+
+      gmac_update(&st, &data[done], n);
+      done+=n;
+    }
+    gmac_final(&st, tag);
+    CHECK(!memcmp(tag, ref_tag, BLK_LEN), "gmac stream len %lu", len);
+
+    ref_tag[r%BLK_LEN]^=0x80;
+    CHECK(aes128gmac_verify(&g, ref_tag, IV, data, len),
+          "gmac forged tag accepted len %lu", len);
+    gmac_init(&st, &g, IV);
+    gmac_update(&st, data, len);
+    CHECK(gmac_final_verify(&st, ref_tag),
+          "gmac stream forged tag accepted len %lu", len);
+    gcm_clear_key(&g);
+  }
+}
+
+//definition of the records of the engine test
+typedef struct
+{
+  gcm_engine *e;
+  gcm_engine_job jobs[ENG_FLOWS][ENG_JOBS];
+  unsigned char pt[ENG_FLOWS][ENG_JOBS][ENG_LEN];
+  unsigned char ct[ENG_FLOWS][ENG_JOBS][ENG_LEN];
+  unsigned char out[ENG_FLOWS][ENG_JOBS][ENG_LEN];
+  unsigned char tag[ENG_FLOWS][ENG_JOBS][BLK_LEN];
+  unsigned char IV[ENG_FLOWS][ENG_JOBS][12];
+  unsigned int next[ENG_FLOWS];//next record expected per flow
+  unsigned long order_errors;
+  unsigned long done;
+}engine_test;
+
+//------------------------------------------------------------------
+//completion of a record, checks the order within its flow
+static void engine_done(gcm_engine_job *job, void *arg)
+{
+  engine_test *t=(engine_test *)arg;
+  unsigned int seq=(unsigned int)(uintptr_t)job->user;
+
+  //the flow is only completed by one worker
+  if(t->next[job->flow]++!=seq)
+    __atomic_fetch_add(&t->order_errors, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&t->done, 1, __ATOMIC_RELEASE);
+}
+
+//definition of the argument of a producer
+typedef struct
+{
+  engine_test *t;
+  unsigned int p;
+}engine_arg;
+
+//------------------------------------------------------------------
+//producer of the flows p, p+ENG_PRODUCERS, ..., records interleaved
+static void *engine_submitter(void *arg)
+{
+  engine_arg *a=(engine_arg *)arg;
+
+  for(unsigned int i=0; i<ENG_JOBS; i++)
+    for(unsigned int f=a->p; f<ENG_FLOWS; f+=ENG_PRODUCERS)
+      while(gcm_engine_submit(a->t->e, &a->t->jobs[f][i]))
+        sched_yield();
+  return NULL;
+}
+
+//------------------------------------------------------------------
+//fills the jobs of all flows with op over in, records of 0 to
+//ENG_LEN bytes
+static void engine_jobs(engine_test *t, const gcm_ctxt *g, int op,
+                        unsigned char (*in)[ENG_JOBS][ENG_LEN])
+{
+  memset(t->next, 0, sizeof(t->next));
+  t->done=t->order_errors=0;
+  for(unsigned int f=0; f<ENG_FLOWS; f++)
+    for(unsigned int i=0; i<ENG_JOBS; i++)
+    {
+      gcm_engine_job *job=&t->jobs[f][i];
+
+      memset(job, 0, sizeof(*job));
+      job->job.gctxt=&g[f%2];
+      job->job.IV=t->IV[f][i];
+      job->job.in=in[f][i];
+      job->job.len=(f*ENG_JOBS+i)*37%(ENG_LEN+1);
+      job->job.out=t->out[f][i];
+      if(op==GCM_ENGINE_DECRYPT)
+        memcpy(job->job.tag, t->tag[f][i], BLK_LEN);
+      job->op=op;
+      job->flow=f;
+      job->user=(void *)(uintptr_t)i;
+    }
+}
+
+//------------------------------------------------------------------
+//producers and callbacks, then a polling consumer with forged tags
+static void test_engine(void)
+{
+  static engine_test t;
+  unsigned char key[2][BLK_LEN];
+  engine_arg args[ENG_PRODUCERS];
+  pthread_t th[ENG_PRODUCERS];
+  gcm_engine_stats st;
+  unsigned long bad=0, forged=0, n=0;
+  gcm_engine e;
+  gcm_ctxt g[2];
+
+  for(int k=0; k<2; k++)
+  {
+    rnd_bytes(key[k], BLK_LEN);
+    gcm_init_key(&g[k], key[k]);
+  }
+  for(unsigned int f=0; f<ENG_FLOWS; f++)
+    for(unsigned int i=0; i<ENG_JOBS; i++)
+    {
+      rnd_bytes(t.IV[f][i], 12);
+      rnd_bytes(t.pt[f][i], ENG_LEN);
+    }
+
+  //encryption, small rings so that the producers hit full rings
+  CHECK(!gcm_engine_init(&e, 3, 16, 0, engine_done, &t), "engine init");
+  t.e=&e;
+  engine_jobs(&t, g, GCM_ENGINE_ENCRYPT, t.pt);
+  for(unsigned int p=0; p<ENG_PRODUCERS; p++)
+  {
+    args[p].t=&t;
+    args[p].p=p;
+    pthread_create(&th[p], NULL, engine_submitter, &args[p]);
+  }
+  for(unsigned int p=0; p<ENG_PRODUCERS; p++)
+    pthread_join(th[p], NULL);
+  while(__atomic_load_n(&t.done, __ATOMIC_ACQUIRE)<ENG_FLOWS*ENG_JOBS)
+    sched_yield();
+  gcm_engine_get_stats(&e, -1, &st);
+  gcm_engine_destroy(&e);
+
+  for(unsigned int f=0; f<ENG_FLOWS; f++)
+    for(unsigned int i=0; i<ENG_JOBS; i++)
+    {
+      gcm_engine_job *job=&t.jobs[f][i];
+      unsigned char tag[BLK_LEN];
+
+      aes128gcm_encrypt(&g[f%2], t.ct[f][i], tag, t.IV[f][i], t.pt[f][i],
+                        job->job.len, NULL, 0);
+      bad+= (job->job.status || memcmp(job->job.out, t.ct[f][i],
+                                       job->job.len) ||
+             memcmp(job->job.tag, tag, BLK_LEN)) ? 1 : 0;
+      memcpy(t.tag[f][i], tag, BLK_LEN);
+    }
+  CHECK(!bad && !t.order_errors, "engine encrypt %lu wrong %lu reordered",
+        bad, t.order_errors);
+  CHECK(st.completed==ENG_FLOWS*ENG_JOBS && !st.failed && st.batches &&
+        st.max_depth<=16 && !st.depth && st.latency_max_ns,
+        "engine stats completed %llu batches %llu depth %lu",
+        st.completed, st.batches, st.max_depth);
+
+  //decryption from one thread, every fifth tag forged
+  CHECK(!gcm_engine_init(&e, 2, 8, 1, NULL, NULL), "engine init poll");
+  engine_jobs(&t, g, GCM_ENGINE_DECRYPT, t.ct);
+  for(unsigned int f=0; f<ENG_FLOWS; f++)
+    for(unsigned int i=0; i<ENG_JOBS; i+=5)
+      t.jobs[f][i].job.tag[i%BLK_LEN]^=1;
+  for(unsigned int s=0; n<ENG_FLOWS*ENG_JOBS; )
+  {
+    gcm_engine_job *job;
+
+    if(s<ENG_FLOWS*ENG_JOBS &&
+       !gcm_engine_submit(&e, &t.jobs[s%ENG_FLOWS][s/ENG_FLOWS]))
+      s++;
+    while((job=gcm_engine_poll(&e)))
+    {
+      unsigned int f=(unsigned int)job->flow;
+      unsigned int i=(unsigned int)(uintptr_t)job->user;
+
+      n++;
+      bad+= (t.next[f]++!=i) ? 1 : 0;
+      if(i%5==0)
+        forged+= job->job.status ? 1 : 0;
+      else
+        bad+= (job->job.status || memcmp(job->job.out, t.pt[f][i],
+                                         job->job.len)) ? 1 : 0;
+    }
+  }
+  gcm_engine_get_stats(&e, 0, &st);
+  gcm_engine_destroy(&e);
+  CHECK(!bad && forged==ENG_FLOWS*((ENG_JOBS+4)/5),
+        "engine decrypt %lu wrong, %lu forged rejected", bad, forged);
+  CHECK(st.failed==(ENG_FLOWS/2)*((ENG_JOBS+4)/5),
+        "engine worker 0 failed %llu", st.failed);
+  gcm_clear_key(&g[0]);
+  gcm_clear_key(&g[1]);
+}
+
+//definition of the IVs drawn by one thread
+typedef struct
+{
+  gcm_nonce_source *src;
+  unsigned int chunk;
+  uint64_t n[NONCE_LIMIT];//invocation fields
+  unsigned long count;
+  unsigned long rekey;//IVs returned with GCM_NONCE_REKEY
+  unsigned long bad_fixed;
+}nonce_draw;
+
+//------------------------------------------------------------------
+//draws IVs until the limit
+static void *nonce_worker(void *arg)
+{
+  nonce_draw *d=(nonce_draw *)arg;
+  gcm_nonce_lease lease;
+  unsigned char IV[12];
+  int r;
+
+  gcm_nonce_lease_init(&lease, d->src, d->chunk);
+  while((r=gcm_nonce_next(&lease, IV))>=0)
+  {
+    uint64_t n=0;
+
+    for(int i=4; i<12; i++)
+      n=(n << 8) | IV[i];
+    d->n[d->count++]=n;
+    d->rekey+= (r==GCM_NONCE_REKEY) ? 1 : 0;
+    d->bad_fixed+= memcmp(IV, d->src->fixed, 4) ? 1 : 0;
+  }
+  return NULL;
+}
+
+//------------------------------------------------------------------
+//threads with leases of different sizes share one source
+static void test_nonce(void)
+{
+  static nonce_draw d[NONCE_THREADS];
+  static unsigned char seen[NONCE_LIMIT];
+  const unsigned char fixed[4]={0xde, 0xad, 0xbe, 0xef};
+  unsigned long total=0, rekey=0, dup=0, bad=0;
+  pthread_t th[NONCE_THREADS];
+  gcm_nonce_lease lease;
+  gcm_nonce_source src;
+  unsigned char IV[12];
+
+  CHECK(gcm_nonce_init(&src, fixed, GCM_NONCE_MAX_LIMIT+1, 0),
+        "nonce limit above the maximum accepted");
+  gcm_nonce_init(&src, fixed, NONCE_LIMIT, NONCE_LIMIT-500);
+  memset(seen, 0, sizeof(seen));
+  for(unsigned int t=0; t<NONCE_THREADS; t++)
+  {
+    d[t].src=&src;
+    d[t].chunk=1+t*37;
+    d[t].count=d[t].rekey=d[t].bad_fixed=0;
+    pthread_create(&th[t], NULL, nonce_worker, &d[t]);
+  }
+  for(unsigned int t=0; t<NONCE_THREADS; t++)
+  {
+    pthread_join(th[t], NULL);
+    for(unsigned long i=0; i<d[t].count; i++)
+    {
+      if(d[t].n[i]>=NONCE_LIMIT)
+        bad++;
+      else
+        dup+= seen[d[t].n[i]]++ ? 1 : 0;
+    }
+    total+=d[t].count;
+    rekey+=d[t].rekey;
+    bad+=d[t].bad_fixed;
+  }
+  CHECK(total==NONCE_LIMIT && !dup && !bad,
+        "nonce %lu issued, %lu duplicates, %lu malformed", total, dup,
+        bad);
+  CHECK(rekey==500 && gcm_nonce_rekey_due(&src), "nonce rekey %lu",
+        rekey);
+  gcm_nonce_lease_init(&lease, &src, 0);
+  CHECK(gcm_nonce_next(&lease, IV)<0, "nonce issued past the limit");
+
+  //retries after the limit with the largest chunk leave the counter
+  //at the limit, it must never wrap back below it
+  gcm_nonce_init(&src, fixed, 10, 0);
+  for(int l=0, issued=0; l<4; l++)
+  {
+    gcm_nonce_lease_init(&lease, &src, 0xffffffffU);
+    for(int i=0; i<100000; i++)
+      if(gcm_nonce_next(&lease, IV)>=0)
+        issued++;
+    CHECK(issued==10 && src.next==10 && lease.spent,
+          "nonce retries past the limit, %d issued, counter %llu",
+          issued, (unsigned long long)src.next);
+  }
+
+  gcm_nonce_init(&src, fixed, 0, 0);
+  gcm_nonce_lease_init(&lease, &src, 0);
+  CHECK(gcm_nonce_next(&lease, IV)==GCM_NONCE_OK && !IV[11] &&
+        gcm_nonce_next(&lease, IV)==GCM_NONCE_OK && IV[11]==1 &&
+        !gcm_nonce_rekey_due(&src), "nonce sequence");
+}
+
+//------------------------------------------------------------------
+//every bulk key expansion against the byte-wise one, and contexts of
+//gcm_init_keys() against gcm_init_key()
+static void test_init_keys(void)
+{
+  static unsigned char key[MAX_KEYS][BLK_LEN];
+  static key_ctxt kc[MAX_KEYS], ref;
+  static gcm_ctxt g[MAX_KEYS], gr;
+  const unsigned char *kp[MAX_KEYS];
+  key_ctxt *kcp[MAX_KEYS];
+  gcm_ctxt *gp[MAX_KEYS];
+  unsigned char pt[200], ct[200], ct_ref[200], IV[12];
+  unsigned char tag[BLK_LEN], tag_ref[BLK_LEN];
+  unsigned int counts[]={0, 1, 7, 16, 17, 64, 65, MAX_KEYS};
+  key_ctxt probe;
+
+  for(unsigned int i=0; i<MAX_KEYS; i++)
+  {
+    kp[i]=key[i];
+    kcp[i]=&kc[i];
+    gp[i]=&g[i];
+  }
+  for(unsigned int c=0; c<sizeof(counts)/sizeof(counts[0]); c++)
+  {
+    unsigned int n=counts[c];
+    unsigned long bad=0;
+
+    rnd_bytes(&key[0][0], sizeof(key));
+    for(int v=0; v<3; v++)
+    {
+      //AES-NI and VAES kernels only where the host has them
+      if(v==1 && aes128e_set_backend(&probe, AES128E_AESNI))
+        continue;
+      if(v==2 && aes128e_set_backend(&probe, AES128E_VAES))
+        continue;
+      memset(kc, 0, sizeof(kc));
+      if(v==0)
+        for(unsigned int i=0; i<n; i++)
+          aes128e_expand_words(&kc[i], key[i]);
+      else if(v==1)
+        aes128e_set_keys_aesni(kcp, kp, n);
+      else
+        aes128e_set_keys_vaes(kcp, kp, n);
+      for(unsigned int i=0; i<n; i++)
+      {
+        aes128e_expand_ref(&ref, key[i]);
+        bad+= memcmp(ref.rk, kc[i].rk, sizeof(ref.rk)) ? 1 : 0;
+      }
+      CHECK(!bad, "bulk key expansion %d of %u keys, %lu wrong", v, n,
+            bad);
+    }
+
+    bad=gcm_init_keys(gp, kp, n) ? 1 : 0;
+    for(unsigned int i=0; i<n; i++)
+    {
+      unsigned long len=rnd_len(sizeof(pt));
+
+      rnd_bytes(IV, 12);
+      rnd_bytes(pt, len);
+      bad+= (gcm_init_key(&gr, key[i]) ||
+             gr.ghash!=gcm_default_ghash()) ? 1 : 0;
+      aes128gcm_encrypt(&gr, ct_ref, tag_ref, IV, pt, len, NULL, 0);
+      aes128gcm_encrypt(&g[i], ct, tag, IV, pt, len, NULL, 0);
+      bad+= (memcmp(g[i].H, gr.H, BLK_LEN) || g[i].ghash!=gr.ghash ||
+             g[i].kctxt.backend!=gr.kctxt.backend ||
+             memcmp(ct, ct_ref, len) || memcmp(tag, tag_ref, BLK_LEN)) ?
+            1 : 0;
+      gcm_clear_key(&gr);
+      gcm_clear_key(&g[i]);
+    }
+    CHECK(!bad, "gcm_init_keys of %u keys, %lu differ", n, bad);
+  }
+}
+
+//------------------------------------------------------------------
+//moves a context between every pair of tiers, checks its footprint
+//and that messages match a plain context after each move
+static void test_tier(void)
+{
+  unsigned char key[BLK_LEN], IV[12], pt[200], ct[200], ct_ref[200];
+  unsigned char tag[BLK_LEN], tag_ref[BLK_LEN];
+  gcm_ctxt gr;
+  gcm_tiered t;
+  unsigned long bad=0;
+
+  rnd_bytes(key, BLK_LEN);
+  gcm_init_key(&gr, key);
+  for(int from=0; from<GCM_NTIERS; from++)
+    for(int to=0; to<GCM_NTIERS; to++)
+    {
+      unsigned long len=rnd_len(sizeof(pt));
+      const gcm_ctxt *g;
+
+      rnd_bytes(IV, 12);
+      rnd_bytes(pt, len);
+      aes128gcm_encrypt(&gr, ct_ref, tag_ref, IV, pt, len, NULL, 0);
+      if(gcm_tier_init(&t, key, from) ||
+         gcm_tier_bytes(&t)!=gcm_tier_footprint(from) ||
+         gcm_tier_set(&t, to) || t.tier!=to ||
+         gcm_tier_bytes(&t)!=gcm_tier_footprint(to) ||
+         !(g=gcm_tier_ctxt(&t, to)))
+      {
+        bad++;
+        gcm_tier_clear(&t);
+        continue;
+      }
+      aes128gcm_encrypt(g, ct, tag, IV, pt, len, NULL, 0);
+      bad+= (memcmp(ct, ct_ref, len) || memcmp(tag, tag_ref, BLK_LEN) ||
+             t.tier<GCM_TIER_HASHKEY) ? 1 : 0;
+      gcm_tier_clear(&t);
+    }
+  CHECK(!bad, "tier moves, %lu wrong", bad);
+  gcm_clear_key(&gr);
+
+  gcm_tier_init(&t, key, GCM_TIER_TAB4);
+  CHECK(gcm_tier_set(&t, GCM_NTIERS)==-1 && gcm_tier_set(&t, -1)==-1 &&
+        t.tier==GCM_TIER_TAB4 && gcm_tier_footprint(GCM_NTIERS)==0,
+        "unknown tier");
+  CHECK(gcm_tier_footprint(GCM_TIER_KEY)<gcm_tier_footprint(GCM_TIER_HASHKEY)
+        && gcm_tier_footprint(GCM_TIER_TAB4)<
+           gcm_tier_footprint(GCM_TIER_TAB8), "tier footprints");
+  //the round keys tier holds the AES schedule and little else
+  CHECK(gcm_tier_footprint(GCM_TIER_ROUNDKEYS)<=
+        gcm_tier_footprint(GCM_TIER_KEY)+sizeof(key_ctxt)+64,
+        "tier round keys footprint %zu",
+        gcm_tier_footprint(GCM_TIER_ROUNDKEYS));
+  gcm_tier_clear(&t);
+
+  //the lowest tier handed out hashes in constant time
+  gcm_tier_init(&t, key, GCM_TIER_KEY);
+  CHECK(gcm_tier_ctxt(&t, GCM_TIER_KEY) && t.tier==GCM_TIER_HASHKEY &&
+        t.gctxt->ghash==GHASH_CT, "tier default GHASH backend");
+  gcm_tier_clear(&t);
+}
+
+//definition of the shared state of the key cache threads
+typedef struct
+{
+  gcm_keycache *cache;
+  unsigned char (*keys)[BLK_LEN];
+  unsigned char (*tags)[BLK_LEN];//tag of the empty message per key
+  unsigned int nkeys;
+  unsigned long long seed;
+  unsigned long errors;
+}keycache_work;
+
+//------------------------------------------------------------------
+static void *keycache_worker(void *arg)
+{
+  keycache_work *w=(keycache_work *)arg;
+  unsigned long long s=w->seed;
+  unsigned char IV[12]={0}, tag[BLK_LEN];
+
+  for(int i=0; i<4000; i++)
+  {
+    unsigned int k;
+    const gcm_ctxt *g;
+
+    s=s*6364136223846793005ULL+1442695040888963407ULL;
+    k=(unsigned int)(s >> 33)%w->nkeys;
+    if(!(g=gcm_keycache_get(w->cache, w->keys[k])))
+    {
+      w->errors++;
+      continue;
+    }
+    aes128gcm_encrypt(g, NULL, tag, IV, NULL, 0, NULL, 0);
+    w->errors+= memcmp(tag, w->tags[k], BLK_LEN)!=0;
+    gcm_keycache_release(w->cache, g);
+    if(!(s & 0xff))
+      gcm_keycache_remove(w->cache, w->keys[k]);
+  }
+  return NULL;
+}
+
+//------------------------------------------------------------------
+//LRU order, budget, pins and counters on one thread, then
+//concurrent gets, releases and removes
+static void test_keycache(void)
+{
+  static unsigned char keys[64][BLK_LEN], tags[64][BLK_LEN];
+  unsigned char IV[12]={0}, buf[BLK_LEN];
+  const gcm_ctxt *g, *pinned;
+  keycache_work w[4];
+  pthread_t tid[4];
+  gcm_keycache cache;
+  gcm_keycache_stats st;
+  gcm_ctxt probe;
+  size_t entry;
+
+  for(int k=0; k<64; k++)
+  {
+    rnd_bytes(keys[k], BLK_LEN);
+    ref_gcm(buf, tags[k], keys[k], IV, buf, 0, buf, 0);
+  }
+  //room for four contexts in one shard
+  gcm_init_key(&probe, keys[0]);
+  entry=gcm_key_footprint(&probe)+64;
+  gcm_clear_key(&probe);
+  CHECK(gcm_keycache_init(&cache, 4*entry, 1, NGHASH+1, rnd())==-1,
+        "keycache unknown ghash");
+  CHECK(!gcm_keycache_init(&cache, 4*entry, 1, -1, rnd()), "keycache init");
+
+  for(int k=0; k<4; k++)
+    gcm_keycache_release(&cache, gcm_keycache_get(&cache, keys[k]));
+  //touch keys 0 and 2, key 1 is now the least recently used
+  gcm_keycache_release(&cache, gcm_keycache_get(&cache, keys[0]));
+  pinned=gcm_keycache_get(&cache, keys[2]);
+  gcm_keycache_release(&cache, gcm_keycache_get(&cache, keys[4]));
+  gcm_keycache_get_stats(&cache, &st);
+  CHECK(st.hits==2 && st.misses==5 && st.evictions==1 && st.entries==4 &&
+        st.bytes<=4*entry, "keycache counters %llu/%llu/%llu/%lu",
+        st.hits, st.misses, st.evictions, st.entries);
+  g=gcm_keycache_get(&cache, keys[0]);
+  gcm_keycache_get_stats(&cache, &st);
+  CHECK(st.hits==3, "keycache evicted the wrong key");
+  gcm_keycache_release(&cache, g);
+
+  //a pinned context survives eviction and removal until released
+  for(int k=5; k<12; k++)
+    gcm_keycache_release(&cache, gcm_keycache_get(&cache, keys[k]));
+  gcm_keycache_remove(&cache, keys[2]);
+  aes128gcm_encrypt(pinned, NULL, buf, IV, NULL, 0, NULL, 0);
+  CHECK(!memcmp(buf, tags[2], BLK_LEN), "keycache pinned context damaged");
+  gcm_keycache_release(&cache, pinned);
+  gcm_keycache_get_stats(&cache, &st);
+  CHECK(st.entries<=4 && st.bytes<=4*entry, "keycache over budget");
+  gcm_keycache_destroy(&cache);
+
+  CHECK(!gcm_keycache_init(&cache, 24*entry, 4, -1, rnd()), "keycache init");
+  for(int t=0; t<4; t++)
+  {
+    w[t].cache=&cache;
+    w[t].keys=keys;
+    w[t].tags=tags;
+    w[t].nkeys=64;
+    w[t].seed=rnd();
+    w[t].errors=0;
+    pthread_create(&tid[t], NULL, keycache_worker, &w[t]);
+  }
+  for(int t=0; t<4; t++)
+  {
+    pthread_join(tid[t], NULL);
+    CHECK(!w[t].errors, "keycache thread %d: %lu errors", t, w[t].errors);
+  }
+  gcm_keycache_get_stats(&cache, &st);
+  CHECK(st.hits+st.misses==4*4000 && st.bytes<=24*entry,
+        "keycache concurrent counters");
+  gcm_keycache_destroy(&cache);
+}
+
+//------------------------------------------------------------------
+//container round trips through temporary files, random ranges and
+//chunks moved or modified after encryption
+static void test_chunk(void)
+{
+  static const unsigned long sizes[]={16, 64, 4096};
+  unsigned char key[BLK_LEN], nonce[12];
+  gcm_chunk_header hdr, rd;
+  gcm_ctxt g;
+
+  rnd_bytes(key, BLK_LEN);
+  gcm_init_key(&g, key);
+  for(unsigned int s=0; s<sizeof(sizes)/sizeof(sizes[0]); s++)
+    for(int round=0; round<4; round++)
+    {
+      unsigned long len= round ? rnd_len(40*sizes[s]) : 0;
+      unsigned char *pt=malloc(len+1), *out=malloc(len+1);
+      FILE *fin=tmpfile(), *fct=tmpfile(), *fout=tmpfile();
+      unsigned int nthreads=1+(unsigned int)(rnd()%5);
+
+      rnd_bytes(pt, len);
+      rnd_bytes(nonce, 12);
+      fwrite(pt, 1, len, fin);
+      fflush(fin);
+      CHECK(!aes128gcm_chunk_header_init(&hdr, sizes[s], len, nonce) &&
+            !aes128gcm_chunk_encrypt_fd(&g, fileno(fct), fileno(fin), &hdr,
+                                        nthreads) &&
+            !aes128gcm_chunk_read_header(fileno(fct), &rd) &&
+            rd.len==len && rd.nchunks==hdr.nchunks,
+            "chunk encrypt len %lu chunk %lu", len, sizes[s]);
+      CHECK(!aes128gcm_chunk_decrypt_fd(&g, fileno(fout), fileno(fct),
+                                        nthreads) &&
+            (fseek(fout, 0, SEEK_SET), fread(out, 1, len+1, fout)==len) &&
+            !memcmp(out, pt, len), "chunk decrypt len %lu", len);
+
+      for(int r=0; r<8; r++)
+      {
+        unsigned long long off=rnd()%(len+1);
+        unsigned long n=rnd()%(len-off+1);
+
+        CHECK(!aes128gcm_chunk_decrypt_range(&g, fileno(fct), &rd, out, off,
+                                             n) && !memcmp(out, &pt[off], n),
+              "chunk range %llu+%lu of %lu", off, n, len);
+      }
+      CHECK(aes128gcm_chunk_decrypt_range(&g, fileno(fct), &rd, out, len,
+                                          1), "chunk range past the end");
+
+      //swapped tags of the first two chunks, then a changed length
+      if(hdr.nchunks>1)
+      {
+        unsigned char t2[2*BLK_LEN];
+
+        pread(fileno(fct), t2, sizeof(t2), GCM_CHUNK_HEADER_LEN);
+        pwrite(fileno(fct), &t2[BLK_LEN], BLK_LEN, GCM_CHUNK_HEADER_LEN);
+        pwrite(fileno(fct), t2, BLK_LEN, GCM_CHUNK_HEADER_LEN+BLK_LEN);
+        CHECK(aes128gcm_chunk_decrypt_range(&g, fileno(fct), &rd, out, 0, 1),
+              "chunk swapped tag accepted");
+        pwrite(fileno(fct), t2, sizeof(t2), GCM_CHUNK_HEADER_LEN);
+      }
+      if(len>1)
+      {
+        //a header claiming one byte less
+        rd.len=len-1;
+        for(int i=0; i<8; i++)
+          rd.raw[16+i]=(unsigned char)(rd.len >> (56-8*i));
+        CHECK(aes128gcm_chunk_decrypt_range(&g, fileno(fct), &rd, out, 0,
+                                            (unsigned long)rd.len),
+              "chunk changed length accepted");
+      }
+      CHECK(aes128gcm_chunk_decrypt_fd(&g, fileno(fout), fileno(fin), 1),
+            "plain file taken for a container");
+      fclose(fin);
+      fclose(fct);
+      fclose(fout);
+      free(pt);
+      free(out);
+    }
+  gcm_clear_key(&g);
+}
+
+//------------------------------------------------------------------
+//empty plaintext and AAD, with and without NULL pointers
+static void test_empty(void)
+{
+  unsigned char key[BLK_LEN], IV[12], tag[BLK_LEN], ref_tag[BLK_LEN];
+  unsigned char buf[BLK_LEN];
+  gcm_stream st;
+  gcm_job job;
+  gcm_ctxt g;
+
+  rnd_bytes(key, BLK_LEN);
+  rnd_bytes(IV, 12);
+  ref_gcm(buf, ref_tag, key, IV, buf, 0, buf, 0);
+  gcm_init_key(&g, key);
+
+  CHECK(!aes128gcm_encrypt(&g, NULL, tag, IV, NULL, 0, NULL, 0) &&
+        !memcmp(tag, ref_tag, BLK_LEN), "empty encrypt");
+  for(int mode=GCM_VERIFY_FIRST; mode<=GCM_FUSED; mode++)
+    CHECK(!aes128gcm_decrypt(&g, NULL, ref_tag, IV, NULL, 0, NULL, 0,
+                             mode), "empty decrypt mode %d", mode);
+  CHECK(!aes128gcm_encrypt_mt(&g, NULL, tag, IV, NULL, 0, NULL, 0, 4) &&
+        !memcmp(tag, ref_tag, BLK_LEN), "empty mt encrypt");
+
+  gcm_init(&st, &g, IV);
+  CHECK(!gcm_update_aad(&st, NULL, 0) && !gcm_update(&st, NULL, NULL, 0),
+        "empty stream update");
+  gcm_final(&st, tag);
+  CHECK(!memcmp(tag, ref_tag, BLK_LEN), "empty stream");
+
+  //AAD after data is refused
+  gcm_init(&st, &g, IV);
+  gcm_update(&st, buf, buf, 1);
+  CHECK(gcm_update_aad(&st, buf, 1), "aad after data accepted");
+  gcm_final(&st, tag);
+
+  memset(&job, 0, sizeof(job));
+  job.gctxt=&g;
+  job.IV=IV;
+  CHECK(!aes128gcm_encrypt_batch(&job, 1) && !job.status &&
+        !memcmp(job.tag, ref_tag, BLK_LEN), "empty batch encrypt");
+  CHECK(!aes128gcm_decrypt_batch(&job, 1) && !job.status,
+        "empty batch decrypt");
+  CHECK(!aes128gcm_encrypt_batch(NULL, 0), "empty batch");
+  gcm_clear_key(&g);
+}
+
+//------------------------------------------------------------------
+//the block based aes128gcm() of the original interface
+static void test_legacy(void)
+{
+  unsigned char key[BLK_LEN], IV[12], tag[BLK_LEN], ref_tag[BLK_LEN];
+  unsigned char pt[6*BLK_LEN], ct[6*BLK_LEN], ref[6*BLK_LEN];
+  unsigned char aad[4*BLK_LEN];
+
+  for(unsigned int lp=0; lp<=6; lp++)
+    for(unsigned int la=0; la<=4; la++)
+    {
+      rnd_bytes(key, BLK_LEN);
+      rnd_bytes(IV, 12);
+      rnd_bytes(pt, lp*BLK_LEN);
+      rnd_bytes(aad, la*BLK_LEN);
+      ref_gcm(ref, ref_tag, key, IV, pt, lp*BLK_LEN, aad, la*BLK_LEN);
+      aes128gcm(ct, tag, key, IV, pt, lp, aad, la);
+      CHECK(!memcmp(ct, ref, lp*BLK_LEN) && !memcmp(tag, ref_tag, BLK_LEN),
+            "aes128gcm %u blocks %u aad blocks", lp, la);
+    }
+}
+
+//------------------------------------------------------------------
+//parses up to max bytes of hex, returns the byte count or -1
+static long parse_hex(const char *s, unsigned char *out, unsigned long max)
+{
+  unsigned long n=0;
+
+  while(*s==' ' || *s=='\t')
+    s++;
+  for(; s[0] && s[0]!='\r' && s[0]!='\n' && s[0]!=' '; s+=2)
+  {
+    unsigned int v;
+
+    if(!s[1] || n==max || sscanf(s, "%2x", &v)!=1)
+      return -1;
+    out[n++]=(unsigned char)v;
+  }
+  return (long)n;
+}
+
+//definition of one CAVP test case
+typedef struct
+{
+  unsigned char key[BLK_LEN], IV[128], tag[BLK_LEN];
+  unsigned char *pt, *ct, *aad;
+  long len_key, len_iv, len_pt, len_ct, len_aad, len_tag;
+  int fail;//the file expects the tag check to fail
+}cavp_case;
+
+//------------------------------------------------------------------
+//runs one test case through every backend pair, returns 1 if it was
+//run and 0 if it is outside what the library supports
+static int cavp_run(const cavp_case *tc, const char *file, long count)
+{
+  unsigned char *out=malloc(tc->len_ct+tc->len_pt+1);
+  unsigned char tag[BLK_LEN];
+  gcm_stream st;
+  gcm_ctxt g;
+
+  if(tc->len_key!=BLK_LEN || tc->len_iv!=12 || tc->len_tag<1 ||
+     tc->len_tag>BLK_LEN || !out)
+  {
+    free(out);
+    return 0;
+  }
+  for(int a=0; a<NAES; a++)
+    for(int h=0; h<NGHASH; h++)
+    {
+      if(ctxt_init(&g, tc->key, a, h))
+        continue;
+      if(tc->len_pt>=0)
+      {
+        //encryption vector, or an authentic decryption vector
+        aes128gcm_encrypt(&g, out, tag, tc->IV, tc->pt, tc->len_pt,
+                          tc->aad, tc->len_aad);
+        CHECK(!tc->fail && tc->len_pt==tc->len_ct &&
+              !memcmp(out, tc->ct, tc->len_ct) &&
+              !memcmp(tag, tc->tag, tc->len_tag),
+              "%s count %ld %s/%s", file, count, aes_names[a],
+              ghash_names[h]);
+      }
+      //decryption through the stream, the tag may be truncated
+      gcm_init(&st, &g, tc->IV);
+      gcm_update_aad(&st, tc->aad, tc->len_aad);
+      gcm_update_decrypt(&st, out, tc->ct, tc->len_ct);
+      gcm_final(&st, tag);
+      CHECK(tc->fail==(memcmp(tag, tc->tag, tc->len_tag)!=0) &&
+            (tc->fail || tc->len_pt<0 || !memcmp(out, tc->pt, tc->len_pt)),
+            "%s count %ld %s/%s decrypt", file, count, aes_names[a],
+            ghash_names[h]);
+      if(tc->len_tag==BLK_LEN)
+        CHECK(tc->fail==(aes128gcm_decrypt(&g, out, tc->tag, tc->IV,
+                                           tc->ct, tc->len_ct, tc->aad,
+                                           tc->len_aad, GCM_FUSED)!=0),
+              "%s count %ld %s/%s one shot decrypt", file, count,
+              aes_names[a], ghash_names[h]);
+      gcm_clear_key(&g);
+    }
+  free(out);
+  return 1;
+}
+
+//------------------------------------------------------------------
+//runs the test cases of one .rsp file, returns the number run
+static unsigned long cavp_file(const char *path, unsigned long *skipped)
+{
+  static char line[MAX_LINE];
+  static unsigned char pt[MAX_LINE/2], ct[MAX_LINE/2], aad[MAX_LINE/2];
+  FILE *f=fopen(path, "r");
+  cavp_case tc;
+  long count=-1;
+  unsigned long run=0;
+
+  if(!f)
+  {
+    CHECK(0, "cannot open %s", path);
+    return 0;
+  }
+  memset(&tc, 0, sizeof(tc));
+  tc.pt=pt;
+  tc.ct=ct;
+  tc.aad=aad;
+  tc.len_pt=-1;
+  while(1)
+  {
+    int eof= !fgets(line, sizeof(line), f);
+
+    //a case ends at its Tag and, in decryption files, its PT or FAIL
+    if(count>=0 && (eof || !strncmp(line, "Count", 5)))
+    {
+      if(cavp_run(&tc, path, count))
+        run++;
+      else
+        (*skipped)++;
+      count=-1;
+    }
+    if(eof)
+      break;
+    if(!strncmp(line, "Count = ", 8))
+    {
+      count=strtol(&line[8], NULL, 10);
+      tc.len_pt=-1;
+      tc.len_ct=tc.len_aad=tc.len_tag=tc.len_iv=tc.len_key=0;
+      tc.fail=0;
+    }
+    else if(!strncmp(line, "Key = ", 6))
+      tc.len_key=parse_hex(&line[6], tc.key, sizeof(tc.key));
+    else if(!strncmp(line, "IV = ", 5))
+      tc.len_iv=parse_hex(&line[5], tc.IV, sizeof(tc.IV));
+    else if(!strncmp(line, "PT = ", 5) || !strncmp(line, "PT =", 4))
+      tc.len_pt=parse_hex(&line[4], pt, sizeof(pt));
+    else if(!strncmp(line, "AAD =", 5))
+      tc.len_aad=parse_hex(&line[5], aad, sizeof(aad));
+    else if(!strncmp(line, "CT =", 4))
+      tc.len_ct=parse_hex(&line[4], ct, sizeof(ct));
+    else if(!strncmp(line, "Tag = ", 6))
+      tc.len_tag=parse_hex(&line[6], tc.tag, sizeof(tc.tag));
+    else if(!strncmp(line, "FAIL", 4))
+      tc.fail=1;
+  }
+  fclose(f);
+  return run;
+}
+
+//------------------------------------------------------------------
+static void test_cavp(const char *dir)
+{
+  char path[MAX_LINE];
+  unsigned long run=0, skipped=0;
+  struct dirent *de;
+  DIR *d=opendir(dir);
+
+  if(!d)
+  {
+    CHECK(0, "cannot open %s", dir);
+    return;
+  }
+  while((de=readdir(d)))
+  {
+    size_t n=strlen(de->d_name);
+
+    if(n<4 || strcmp(&de->d_name[n-4], ".rsp") ||
+       strlen(dir)+n+2>sizeof(path))
+      continue;
+    sprintf(path, "%s/%s", dir, de->d_name);
+    run+=cavp_file(path, &skipped);
+  }
+  closedir(d);
+  printf("vectors: %lu cases from %s, %lu skipped (key, IV or tag "
+         "length not supported)\n", run, dir, skipped);
+  //a directory without usable files must not pass unnoticed
+  CHECK(run, "no test vector cases in %s", dir);
+}
+
+//------------------------------------------------------------------
+//test cases 1 to 4 of the GCM specification
+static void test_known_answers(void)
+{
+  static const char *cases[][6]={
+    {"00000000000000000000000000000000", "000000000000000000000000",
+     "", "", "", "58e2fccefa7e3061367f1d57a4e7455a"},
+    {"00000000000000000000000000000000", "000000000000000000000000",
+     "00000000000000000000000000000000", "",
+     "0388dace60b6a392f328c2b971b2fe78", "ab6e47d42cec13bdf53a67b21257bddf"},
+    {"feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+     "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+     "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255",
+     "",
+     "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+     "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985",
+     "4d5c2af327cd64a62cf35abd2ba6fab4"},
+    {"feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+     "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+     "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+     "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+     "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+     "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+     "5bc94fbc3221a5db94fae95ae7121a47"}};
+  static unsigned char pt[64], ct[64], aad[64];
+  cavp_case tc;
+
+  for(unsigned int i=0; i<sizeof(cases)/sizeof(cases[0]); i++)
+  {
+    unsigned char ref_ct[64], ref_tag[BLK_LEN];
+
+    memset(&tc, 0, sizeof(tc));
+    tc.pt=pt;
+    tc.ct=ct;
+    tc.aad=aad;
+    tc.len_key=parse_hex(cases[i][0], tc.key, sizeof(tc.key));
+    tc.len_iv=parse_hex(cases[i][1], tc.IV, sizeof(tc.IV));
+    tc.len_pt=parse_hex(cases[i][2], pt, sizeof(pt));
+    tc.len_aad=parse_hex(cases[i][3], aad, sizeof(aad));
+    tc.len_ct=parse_hex(cases[i][4], ct, sizeof(ct));
+    tc.len_tag=parse_hex(cases[i][5], tc.tag, sizeof(tc.tag));
+
+    //the reference model itself has to reproduce the specification
+    ref_gcm(ref_ct, ref_tag, tc.key, tc.IV, pt, tc.len_pt, aad, tc.len_aad);
+    CHECK(!memcmp(ref_ct, ct, tc.len_ct) && !memcmp(ref_tag, tc.tag, BLK_LEN),
+          "reference model, test case %u", i+1);
+    cavp_run(&tc, "specification", (long)i+1);
+  }
+}
+
+//------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+  const char *dir=NULL;
+  unsigned long long seed=0x243f6a8885a308d3ULL;
+  unsigned long rounds=100;
+  int opt;
+
+  while((opt=getopt(argc, argv, "v:s:n:h"))!=-1)
+  {
+    switch(opt)
+    {
+      case 'v':
+        dir=optarg;
+        break;
+      case 's':
+        seed=strtoull(optarg, NULL, 0);
+        break;
+      case 'n':
+        rounds=strtoul(optarg, NULL, 0);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-v vector_dir] [-s seed] [-n rounds]\n",
+                argv[0]);
+        return opt!='h';
+    }
+  }
+  rng_state= seed ? seed : 1;
+  printf("seed %#llx, %lu rounds\n", seed, rounds);
+
+  test_known_answers();
+  if(dir)
+    test_cavp(dir);
+  test_aes_blocks();
+  test_ghash();
+  test_legacy();
+  test_empty();
+  test_messages(rounds);
+  test_segment_wrap();
+  test_batch(rounds/4+1);
+  test_mt();
+  test_chunk();
+  test_precomp(rounds);
+  test_keycache();
+  test_iov(rounds);
+  test_stats();
+  test_gmac(rounds);
+  test_init_keys();
+  test_tier();
+  test_engine();
+  test_nonce();
+
+  printf("%lu checks, %lu failures\n", checks, failures);
+  printf("%s\n", failures ? "FAIL" : "PASS");
+  return failures!=0;
+}
@@ -0,0 +1,151 @@
+//-------------------------------------------------------------------
+// FILE: aes128gcm_tier.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  precompute tiers of a key context. from GCM_TIER_ROUNDKEYS on the
+//  state is one heap gcm_ctxt whose GHASH backend follows the tier,
+//  GHASH_CT at GCM_TIER_HASHKEY and no table below; a promotion only
+//  derives what the current tier lacks and a demotion wipes what the
+//  new tier does not keep
+//-------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "aes128gcm_tier.h"
+#include "aes128gcm_impl.h"
+
+#define BLK_LEN 16
+
+//GHASH backend kept at a tier
+static int tier_ghash(int tier)
+{
+  switch(tier)
+  {
+    case GCM_TIER_TAB4:
+      return GHASH_TAB4;
+    case GCM_TIER_TAB8:
+      return GHASH_TAB8;
+    case GCM_TIER_POWERS:
+      return gcm_default_ghash();
+    default:
+      return GHASH_CT;
+  }
+}
+
+//drops the GHASH table, the round keys tier has no H to hash with
+static void drop_table(gcm_ctxt *g)
+{
+  if(g->htab)
+  {
+    aes128e_wipe(g->htab, gcm_htab_size(g->ghash));
+    free(g->htab);
+    g->htab=NULL;
+  }
+  g->ghash=GHASH_CT;
+}
+
+//------------------------------------------------------------------
+int gcm_tier_init(gcm_tiered *t, const unsigned char *k, int tier)
+{
+  memcpy(t->key, k, BLK_LEN);
+  t->tier=GCM_TIER_KEY;
+  t->gctxt=NULL;
+  return gcm_tier_set(t, tier);
+}
+
+//------------------------------------------------------------------
+int gcm_tier_set(gcm_tiered *t, int tier)
+{
+  static const unsigned char zero[BLK_LEN];
+  int old=t->tier;
+  gcm_ctxt *g=t->gctxt;
+
+  if(tier<GCM_TIER_KEY || tier>=GCM_NTIERS)
+    return -1;
+  if(tier==GCM_TIER_KEY)
+  {
+    if(g)
+    {
+      gcm_clear_key(g);
+      free(g);
+      t->gctxt=NULL;
+    }
+    t->tier=tier;
+    return 0;
+  }
+
+  if(!g)
+  {
+    if(!(g=malloc(sizeof(*g))))
+      return -1;
+    aes128e_set_key(&g->kctxt, t->key);
+    memset(g->H, 0, BLK_LEN);
+    g->ghash=GHASH_CT;
+    g->htab=NULL;
+    t->gctxt=g;
+    t->tier=GCM_TIER_ROUNDKEYS;
+  }
+  if(tier==GCM_TIER_ROUNDKEYS)
+  {
+    drop_table(g);
+    aes128e_wipe(g->H, BLK_LEN);
+    t->tier=tier;
+    return 0;
+  }
+
+  if(t->tier<GCM_TIER_HASHKEY)
+  {
+    aes128e_blocks(&g->kctxt, g->H, zero, 1);
+    t->tier=GCM_TIER_HASHKEY;
+  }
+  if((!g->htab || g->ghash!=tier_ghash(tier)) &&
+     gcm_set_ghash(g, tier_ghash(tier)))
+  {
+    //the previous table is still in place, undo a promotion from
+    //below GCM_TIER_HASHKEY
+    if(old<GCM_TIER_HASHKEY)
+      gcm_tier_set(t, old);
+    return -1;
+  }
+  t->tier=tier;
+  return 0;
+}
+
+//------------------------------------------------------------------
+const gcm_ctxt *gcm_tier_ctxt(gcm_tiered *t, int min_tier)
+{
+  if(min_tier<GCM_TIER_HASHKEY)
+    min_tier=GCM_TIER_HASHKEY;
+  if(t->tier<min_tier && gcm_tier_set(t, min_tier))
+    return NULL;
+  return t->gctxt;
+}
+
+//------------------------------------------------------------------
+size_t gcm_tier_footprint(int tier)
+{
+  if(tier<GCM_TIER_KEY || tier>=GCM_NTIERS)
+    return 0;
+  if(tier==GCM_TIER_KEY)
+    return sizeof(gcm_tiered);
+  if(tier==GCM_TIER_ROUNDKEYS)
+    return sizeof(gcm_tiered)+sizeof(gcm_ctxt);
+  return sizeof(gcm_tiered)+sizeof(gcm_ctxt)+gcm_htab_size(tier_ghash(tier));
+}
+
+//------------------------------------------------------------------
+size_t gcm_tier_bytes(const gcm_tiered *t)
+{
+  return sizeof(*t)+(t->gctxt ? gcm_key_footprint(t->gctxt) : 0);
+}
+
+//------------------------------------------------------------------
+void gcm_tier_clear(gcm_tiered *t)
+{
+  gcm_tier_set(t, GCM_TIER_KEY);
+  aes128e_wipe(t, sizeof(*t));
+}
+
+//end of file
@@ -0,0 +1,86 @@
+#ifndef AES128GCM_TIER_H
+#define AES128GCM_TIER_H
+//-------------------------------------------------------------------
+// FILE: aes128gcm_tier.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  key contexts with an explicit precompute tier, for hosts keeping
+//  millions of mostly idle sessions. the lowest tier holds the raw
+//  key only, every higher tier adds state that makes messages
+//  cheaper: round keys, H, a GHASH table and finally the H powers of
+//  the fastest GHASH backend. a context is promoted or demoted at
+//  runtime and dropped state is wiped. a tiered context is not
+//  thread safe, callers serialize its use
+//-------------------------------------------------------------------
+
+#include "aes128gcm.h"
+
+//precompute tiers, in order of speed
+enum
+{
+  GCM_TIER_KEY=0, //raw key only
+  GCM_TIER_ROUNDKEYS, //expanded round keys
+  GCM_TIER_HASHKEY, //round keys and H, GHASH_CT
+  GCM_TIER_TAB4, //and the GHASH_TAB4 table
+  GCM_TIER_TAB8, //and the GHASH_TAB8 table
+  GCM_TIER_POWERS, //and the H powers of gcm_default_ghash()
+  GCM_NTIERS
+};
+
+//definition of a tiered key context
+typedef struct
+{
+  unsigned char key[16];//raw key, kept at every tier
+  int tier;
+  gcm_ctxt *gctxt;//NULL at GCM_TIER_KEY
+}gcm_tiered;
+
+int gcm_tier_init(gcm_tiered *t, const unsigned char *k, int tier);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  sets up a context of the 16-byte key k at the given tier.
+//  returns 0 on success, -1 if tier is unknown or the state cannot be
+//  allocated, then the context is left at GCM_TIER_KEY. release with
+//  gcm_tier_clear()
+//------------------------------------------------------------------
+
+int gcm_tier_set(gcm_tiered *t, int tier);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  promotes or demotes the context to tier, computing only the state
+//  missing and wiping the state no longer kept. returns 0 on success,
+//  -1 if tier is unknown or an allocation fails; the context keeps
+//  its tier in that case
+//------------------------------------------------------------------
+
+const gcm_ctxt *gcm_tier_ctxt(gcm_tiered *t, int min_tier);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  the gcm_ctxt for the encryption, decryption and GMAC calls,
+//  promoting the context to min_tier first if it is below, and at
+//  least to GCM_TIER_HASHKEY, whose GHASH_CT is constant time. the
+//  context stays valid until it is demoted below GCM_TIER_HASHKEY or
+//  cleared. returns NULL if the promotion fails
+//------------------------------------------------------------------
+
+size_t gcm_tier_footprint(int tier);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  bytes a context at tier holds on this host, the structure and its
+//  allocations without allocator overhead. 0 for an unknown tier
+//------------------------------------------------------------------
+
+size_t gcm_tier_bytes(const gcm_tiered *t);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  bytes the context holds now, gcm_tier_footprint() of its tier
+//------------------------------------------------------------------
+
+void gcm_tier_clear(gcm_tiered *t);
+//------------------------------------------------------------------
+// DESCRIPTION:
+//  wipes the key and all derived state and frees it
+//------------------------------------------------------------------
+
+#endif
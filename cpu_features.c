@@ -0,0 +1,70 @@
+//-------------------------------------------------------------------
+// FILE: cpu_features.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// MODIFIED: 17-oct-2026 //AVX-512 VAES/VPCLMULQDQ detection
+// DESCRIPTION:
+//  CPUID based detection of the hardware backends
+//-------------------------------------------------------------------
+
+#include <stdlib.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#include "cpu_features.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+//-------------------------------------------------------------------
+//XCR0 register, the state components the OS saves on a context
+//switch. XGETBV is emitted as bytes, it needs no -mxsave
+static unsigned int xgetbv0(void)
+{
+  unsigned int lo, hi;
+
+  __asm__ volatile(".byte 0x0f, 0x01, 0xd0" : "=a"(lo), "=d"(hi) : "c"(0));
+  return lo;
+}
+#endif
+
+//-------------------------------------------------------------------
+static int detect(void)
+{
+  int f=0;
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int a, b, c, d;
+
+  if(__get_cpuid(1, &a, &b, &c, &d))
+  {
+    if(c & bit_AES)
+      f|=CPU_AESNI;
+    if(c & bit_PCLMUL)
+      f|=CPU_PCLMUL;
+    if((c & bit_SSSE3) && (c & bit_SSE4_1))
+      f|=CPU_SSE41;
+    //the zmm registers and mask registers have to be enabled in XCR0
+    //(SSE, AVX, opmask, ZMM_Hi256, Hi16_ZMM) besides the CPUID bits
+    if((c & bit_OSXSAVE) && (xgetbv0() & 0xe6)==0xe6 &&
+       __get_cpuid_count(7, 0, &a, &b, &c, &d) &&
+       (b & bit_AVX512F) && (b & bit_AVX512BW) && (b & bit_AVX512VL) &&
+       (c & bit_VAES) && (c & bit_VPCLMULQDQ))
+      f|=CPU_VAES512;
+  }
+#endif
+  return f;
+}
+
+//-------------------------------------------------------------------
+int cpu_features(void)
+{
+  //every thread computes the same value, so a racing first call is
+  //harmless
+  static volatile int features=-1;
+
+  if(features<0)
+    features= getenv("AES128_NO_HWACCEL") ? 0 : detect();
+  return features;
+}
+
+//end of file
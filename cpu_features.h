@@ -0,0 +1,29 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+//-------------------------------------------------------------------
+// FILE: cpu_features.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// MODIFIED: 17-oct-2026 //AVX-512 VAES/VPCLMULQDQ detection
+// DESCRIPTION:
+//  runtime detection of the instruction set extensions used by the
+//  hardware backends of aes128e and aes128gcm
+//-------------------------------------------------------------------
+
+#define CPU_AESNI   0x01 //AESENC/AESENCLAST/AESKEYGENASSIST
+#define CPU_PCLMUL  0x02 //PCLMULQDQ carry-less multiply
+#define CPU_SSE41   0x04 //SSE4.1 (and SSSE3) shuffles and inserts
+#define CPU_VAES512 0x08 //VAES and VPCLMULQDQ on 512-bit registers,
+                         //AVX-512 F/BW/VL enabled by the OS
+
+int cpu_features(void);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  returns the CPU_* flags supported by the host. detection runs
+//  once, later calls return the cached value. setting the environment
+//  variable AES128_NO_HWACCEL masks all flags so that only the
+//  portable backends are used
+//-------------------------------------------------------------------
+
+#endif
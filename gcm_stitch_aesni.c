@@ -0,0 +1,206 @@
+//-------------------------------------------------------------------
+// FILE: gcm_stitch_aesni.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  single pass GCM encryption and decryption with AES-NI and PCLMULQDQ. the AES
+//  rounds of 8 counter blocks are interleaved with the carry-less
+//  multiplies of the previous 8 ciphertext blocks, so the ciphertext
+//  is hashed from registers and both execution units stay busy. must
+//  be compiled with -maes -mpclmul -msse4.1, it is only used when the
+//  key context runs AES128E_AESNI and GHASH_CLMUL
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+
+#include "aes128e.h"
+#include "aes128gcm.h"
+#include "ghash_impl.h"
+
+#if defined(__AES__) && defined(__PCLMUL__) && defined(__SSE4_1__)
+
+#include "ghash_clmul_inline.h"
+
+#define LANES GHASH_CLMUL_POWERS
+
+//-------------------------------------------------------------------
+static inline void load_ctr(__m128i base, uint32_t n, __m128i *b)
+{
+  for(int j=0; j<LANES; j++)
+    b[j]=_mm_insert_epi32(base, (int)__builtin_bswap32(n+j), 3);
+}
+
+//-------------------------------------------------------------------
+void gcm_stitch_aesni(const key_ctxt *kctxt, const void *htab,
+                      unsigned char *out, const unsigned char *in,
+                      unsigned char *ctr, unsigned char *Y,
+                      unsigned long ngroups)
+{
+  __m128i rk[AES128_ROUNDS+1];
+  __m128i hpow[LANES];
+  __m128i b[LANES], prev[LANES];
+  __m128i y=bswap(_mm_loadu_si128((const __m128i *)Y));
+  __m128i base=_mm_loadu_si128((const __m128i *)ctr);
+  uint32_t n= ((uint32_t)ctr[12] << 24) | ((uint32_t)ctr[13] << 16) |
+              ((uint32_t)ctr[14] << 8) | (uint32_t)ctr[15];
+
+  if(!ngroups)
+    return;
+  for(int r=0; r<=AES128_ROUNDS; r++)
+    rk[r]=_mm_loadu_si128((const __m128i *)kctxt->rk[r]);
+  for(int j=0; j<LANES; j++)
+    hpow[j]=_mm_loadu_si128((const __m128i *)htab+j);
+
+  //first group, nothing to hash yet
+  load_ctr(base, n, b);
+  n+=LANES;
+  for(int j=0; j<LANES; j++)
+    b[j]=_mm_xor_si128(b[j], rk[0]);
+  for(int r=1; r<AES128_ROUNDS; r++)
+    for(int j=0; j<LANES; j++)
+      b[j]=_mm_aesenc_si128(b[j], rk[r]);
+  for(int j=0; j<LANES; j++)
+  {
+    b[j]=_mm_aesenclast_si128(b[j], rk[AES128_ROUNDS]);
+    b[j]=_mm_xor_si128(b[j], _mm_loadu_si128((const __m128i *)in+j));
+    _mm_storeu_si128((__m128i *)out+j, b[j]);
+    prev[j]=bswap(b[j]);
+  }
+  in+=16*LANES;
+  out+=16*LANES;
+
+  for(ngroups--; ngroups; ngroups--, in+=16*LANES, out+=16*LANES)
+  {
+    __m128i lo=_mm_setzero_si128(), hi=_mm_setzero_si128();
+
+    load_ctr(base, n, b);
+    n+=LANES;
+    prev[0]=_mm_xor_si128(prev[0], y);
+    for(int j=0; j<LANES; j++)
+      b[j]=_mm_xor_si128(b[j], rk[0]);
+    //one multiply of the previous group per AES round
+    for(int r=1; r<AES128_ROUNDS; r++)
+    {
+      for(int j=0; j<LANES; j++)
+        b[j]=_mm_aesenc_si128(b[j], rk[r]);
+      if(r<=LANES)
+        clmul_acc(prev[r-1], hpow[LANES-r], &lo, &hi);
+    }
+    for(int j=0; j<LANES; j++)
+    {
+      b[j]=_mm_aesenclast_si128(b[j], rk[AES128_ROUNDS]);
+      b[j]=_mm_xor_si128(b[j], _mm_loadu_si128((const __m128i *)in+j));
+      _mm_storeu_si128((__m128i *)out+j, b[j]);
+    }
+    y=gf_reduce(lo, hi);
+    for(int j=0; j<LANES; j++)
+      prev[j]=bswap(b[j]);
+  }
+
+  //hash the last group
+  {
+    __m128i lo=_mm_setzero_si128(), hi=_mm_setzero_si128();
+
+    prev[0]=_mm_xor_si128(prev[0], y);
+    for(int j=0; j<LANES; j++)
+      clmul_acc(prev[j], hpow[LANES-1-j], &lo, &hi);
+    y=gf_reduce(lo, hi);
+  }
+
+  _mm_storeu_si128((__m128i *)Y, bswap(y));
+  ctr[12]=(unsigned char)(n >> 24);
+  ctr[13]=(unsigned char)(n >> 16);
+  ctr[14]=(unsigned char)(n >> 8);
+  ctr[15]=(unsigned char)n;
+}
+
+//-------------------------------------------------------------------
+void gcm_stitch_aesni_dec(const key_ctxt *kctxt, const void *htab,
+                          unsigned char *out, const unsigned char *in,
+                          unsigned char *ctr, unsigned char *Y,
+                          unsigned long ngroups)
+{
+  __m128i rk[AES128_ROUNDS+1];
+  __m128i hpow[LANES];
+  __m128i b[LANES], c[LANES];
+  __m128i y=bswap(_mm_loadu_si128((const __m128i *)Y));
+  __m128i base=_mm_loadu_si128((const __m128i *)ctr);
+  uint32_t n= ((uint32_t)ctr[12] << 24) | ((uint32_t)ctr[13] << 16) |
+              ((uint32_t)ctr[14] << 8) | (uint32_t)ctr[15];
+
+  for(int r=0; r<=AES128_ROUNDS; r++)
+    rk[r]=_mm_loadu_si128((const __m128i *)kctxt->rk[r]);
+  for(int j=0; j<LANES; j++)
+    hpow[j]=_mm_loadu_si128((const __m128i *)htab+j);
+
+  for(; ngroups; ngroups--, in+=16*LANES, out+=16*LANES)
+  {
+    __m128i lo=_mm_setzero_si128(), hi=_mm_setzero_si128();
+
+    //the ciphertext is read before out is written, in place is fine
+    for(int j=0; j<LANES; j++)
+      c[j]=_mm_loadu_si128((const __m128i *)in+j);
+    load_ctr(base, n, b);
+    n+=LANES;
+    for(int j=0; j<LANES; j++)
+      b[j]=_mm_xor_si128(b[j], rk[0]);
+    for(int r=1; r<AES128_ROUNDS; r++)
+    {
+      for(int j=0; j<LANES; j++)
+        b[j]=_mm_aesenc_si128(b[j], rk[r]);
+      if(r<=LANES)
+      {
+        __m128i x=bswap(c[r-1]);
+        if(r==1)
+          x=_mm_xor_si128(x, y);
+        clmul_acc(x, hpow[LANES-r], &lo, &hi);
+      }
+    }
+    for(int j=0; j<LANES; j++)
+    {
+      b[j]=_mm_aesenclast_si128(b[j], rk[AES128_ROUNDS]);
+      _mm_storeu_si128((__m128i *)out+j, _mm_xor_si128(b[j], c[j]));
+    }
+    y=gf_reduce(lo, hi);
+  }
+
+  _mm_storeu_si128((__m128i *)Y, bswap(y));
+  ctr[12]=(unsigned char)(n >> 24);
+  ctr[13]=(unsigned char)(n >> 16);
+  ctr[14]=(unsigned char)(n >> 8);
+  ctr[15]=(unsigned char)n;
+}
+
+#else
+
+//built without AES-NI/PCLMULQDQ support, never selected by
+//gcm_update(). encrypts and hashes group by group instead
+void gcm_stitch_aesni(const key_ctxt *kctxt, const void *htab,
+                      unsigned char *out, const unsigned char *in,
+                      unsigned char *ctr, unsigned char *Y,
+                      unsigned long ngroups)
+{
+  for(; ngroups; ngroups--, in+=16*GHASH_CLMUL_POWERS,
+                            out+=16*GHASH_CLMUL_POWERS)
+  {
+    aes128e_ctr32(kctxt, out, in, ctr, GHASH_CLMUL_POWERS);
+    ghash_clmul(htab, Y, out, GHASH_CLMUL_POWERS);
+  }
+}
+
+void gcm_stitch_aesni_dec(const key_ctxt *kctxt, const void *htab,
+                          unsigned char *out, const unsigned char *in,
+                          unsigned char *ctr, unsigned char *Y,
+                          unsigned long ngroups)
+{
+  for(; ngroups; ngroups--, in+=16*GHASH_CLMUL_POWERS,
+                            out+=16*GHASH_CLMUL_POWERS)
+  {
+    ghash_clmul(htab, Y, in, GHASH_CLMUL_POWERS);
+    aes128e_ctr32(kctxt, out, in, ctr, GHASH_CLMUL_POWERS);
+  }
+}
+
+#endif
+
+//end of file
@@ -0,0 +1,202 @@
+//-------------------------------------------------------------------
+// FILE: gcm_stitch_vaes.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  single pass GCM encryption and decryption with AVX-512 VAES and
+//  VPCLMULQDQ, the wide form of gcm_stitch_aesni.c. 16 counter blocks
+//  in 4 registers go through the AES rounds while the previous 16
+//  ciphertext blocks are multiplied by H^16..H^1, one register of
+//  products per round, with one reduction per group. must be compiled
+//  with the VAES_FLAGS of the Makefile, it is only used when the key
+//  context runs AES128E_VAES and GHASH_VCLMUL
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+
+#include "aes128e.h"
+#include "aes128gcm.h"
+#include "ghash_impl.h"
+
+#if defined(__VAES__) && defined(__VPCLMULQDQ__) && \
+    defined(__AVX512F__) && defined(__AVX512BW__) && defined(__PCLMUL__)
+
+#include "aes128e_vaes_inline.h"
+#include "ghash_vclmul_inline.h"
+
+//-------------------------------------------------------------------
+static inline void load_hpow(const void *htab, __m512i *hpow)
+{
+  const __m128i *hz=(const __m128i *)htab+GHASH_CLMUL_POWERS;
+
+  for(int j=0; j<VAES_REGS; j++)
+    hpow[j]=_mm512_loadu_si512(hz+VAES_LANES*j);
+}
+
+//-------------------------------------------------------------------
+static inline void store_ctr(unsigned char *ctr, uint32_t n)
+{
+  ctr[12]=(unsigned char)(n >> 24);
+  ctr[13]=(unsigned char)(n >> 16);
+  ctr[14]=(unsigned char)(n >> 8);
+  ctr[15]=(unsigned char)n;
+}
+
+//-------------------------------------------------------------------
+void gcm_stitch_vaes(const key_ctxt *kctxt, const void *htab,
+                     unsigned char *out, const unsigned char *in,
+                     unsigned char *ctr, unsigned char *Y,
+                     unsigned long ngroups)
+{
+  __m512i rk[AES128_ROUNDS+1];
+  __m512i hpow[VAES_REGS];
+  __m512i b[VAES_REGS], prev[VAES_REGS];
+  __m512i lo, mid, hi;
+  __m128i y=bswap(_mm_loadu_si128((const __m128i *)Y));
+  vaes_ctr vc;
+  uint32_t n= ((uint32_t)ctr[12] << 24) | ((uint32_t)ctr[13] << 16) |
+              ((uint32_t)ctr[14] << 8) | (uint32_t)ctr[15];
+
+  if(!ngroups)
+    return;
+  vaes_load_keys(kctxt, rk);
+  load_hpow(htab, hpow);
+  vaes_ctr_init(&vc, ctr, n);
+  n+=(uint32_t)(VAES_BLOCKS*ngroups);
+
+  //first group, nothing to hash yet
+  for(int j=0; j<VAES_REGS; j++)
+    b[j]=vaes_ctr_next(&vc);
+  vaes_encrypt(rk, b, VAES_REGS);
+  for(int j=0; j<VAES_REGS; j++)
+  {
+    b[j]=_mm512_xor_si512(b[j], _mm512_loadu_si512(in+64*j));
+    _mm512_storeu_si512(out+64*j, b[j]);
+    prev[j]=bswap512(b[j]);
+  }
+  in+=16*VAES_BLOCKS;
+  out+=16*VAES_BLOCKS;
+
+  for(ngroups--; ngroups; ngroups--, in+=16*VAES_BLOCKS,
+                          out+=16*VAES_BLOCKS)
+  {
+    lo=mid=hi=_mm512_setzero_si512();
+    for(int j=0; j<VAES_REGS; j++)
+      b[j]=_mm512_xor_si512(vaes_ctr_next(&vc), rk[0]);
+    prev[0]=_mm512_xor_si512(prev[0], _mm512_zextsi128_si512(y));
+    //one register of products of the previous group per AES round
+    for(int r=1; r<AES128_ROUNDS; r++)
+    {
+      for(int j=0; j<VAES_REGS; j++)
+        b[j]=_mm512_aesenc_epi128(b[j], rk[r]);
+      if(r<=VAES_REGS)
+        clmul512_acc(prev[r-1], hpow[r-1], &lo, &mid, &hi);
+    }
+    for(int j=0; j<VAES_REGS; j++)
+    {
+      b[j]=_mm512_aesenclast_epi128(b[j], rk[AES128_ROUNDS]);
+      b[j]=_mm512_xor_si512(b[j], _mm512_loadu_si512(in+64*j));
+      _mm512_storeu_si512(out+64*j, b[j]);
+    }
+    y=gf_reduce512(lo, mid, hi);
+    for(int j=0; j<VAES_REGS; j++)
+      prev[j]=bswap512(b[j]);
+  }
+
+  //hash the last group
+  lo=mid=hi=_mm512_setzero_si512();
+  prev[0]=_mm512_xor_si512(prev[0], _mm512_zextsi128_si512(y));
+  for(int j=0; j<VAES_REGS; j++)
+    clmul512_acc(prev[j], hpow[j], &lo, &mid, &hi);
+  y=gf_reduce512(lo, mid, hi);
+
+  _mm_storeu_si128((__m128i *)Y, bswap(y));
+  store_ctr(ctr, n);
+}
+
+//-------------------------------------------------------------------
+void gcm_stitch_vaes_dec(const key_ctxt *kctxt, const void *htab,
+                         unsigned char *out, const unsigned char *in,
+                         unsigned char *ctr, unsigned char *Y,
+                         unsigned long ngroups)
+{
+  __m512i rk[AES128_ROUNDS+1];
+  __m512i hpow[VAES_REGS];
+  __m512i b[VAES_REGS], c[VAES_REGS];
+  __m128i y=bswap(_mm_loadu_si128((const __m128i *)Y));
+  vaes_ctr vc;
+  uint32_t n= ((uint32_t)ctr[12] << 24) | ((uint32_t)ctr[13] << 16) |
+              ((uint32_t)ctr[14] << 8) | (uint32_t)ctr[15];
+
+  vaes_load_keys(kctxt, rk);
+  load_hpow(htab, hpow);
+  vaes_ctr_init(&vc, ctr, n);
+  n+=(uint32_t)(VAES_BLOCKS*ngroups);
+
+  for(; ngroups; ngroups--, in+=16*VAES_BLOCKS, out+=16*VAES_BLOCKS)
+  {
+    __m512i lo=_mm512_setzero_si512(), mid=_mm512_setzero_si512();
+    __m512i hi=_mm512_setzero_si512();
+
+    //the ciphertext is read before out is written, in place is fine
+    for(int j=0; j<VAES_REGS; j++)
+      c[j]=_mm512_loadu_si512(in+64*j);
+    for(int j=0; j<VAES_REGS; j++)
+      b[j]=_mm512_xor_si512(vaes_ctr_next(&vc), rk[0]);
+    for(int r=1; r<AES128_ROUNDS; r++)
+    {
+      for(int j=0; j<VAES_REGS; j++)
+        b[j]=_mm512_aesenc_epi128(b[j], rk[r]);
+      if(r<=VAES_REGS)
+      {
+        __m512i x=bswap512(c[r-1]);
+        if(r==1)
+          x=_mm512_xor_si512(x, _mm512_zextsi128_si512(y));
+        clmul512_acc(x, hpow[r-1], &lo, &mid, &hi);
+      }
+    }
+    for(int j=0; j<VAES_REGS; j++)
+    {
+      b[j]=_mm512_aesenclast_epi128(b[j], rk[AES128_ROUNDS]);
+      _mm512_storeu_si512(out+64*j, _mm512_xor_si512(b[j], c[j]));
+    }
+    y=gf_reduce512(lo, mid, hi);
+  }
+
+  _mm_storeu_si128((__m128i *)Y, bswap(y));
+  store_ctr(ctr, n);
+}
+
+#else
+
+//built without VAES/VPCLMULQDQ support, never selected by
+//gcm_update(). encrypts and hashes group by group instead
+void gcm_stitch_vaes(const key_ctxt *kctxt, const void *htab,
+                     unsigned char *out, const unsigned char *in,
+                     unsigned char *ctr, unsigned char *Y,
+                     unsigned long ngroups)
+{
+  for(; ngroups; ngroups--, in+=16*GHASH_VCLMUL_POWERS,
+                            out+=16*GHASH_VCLMUL_POWERS)
+  {
+    aes128e_ctr32(kctxt, out, in, ctr, GHASH_VCLMUL_POWERS);
+    ghash_vclmul(htab, Y, out, GHASH_VCLMUL_POWERS);
+  }
+}
+
+void gcm_stitch_vaes_dec(const key_ctxt *kctxt, const void *htab,
+                         unsigned char *out, const unsigned char *in,
+                         unsigned char *ctr, unsigned char *Y,
+                         unsigned long ngroups)
+{
+  for(; ngroups; ngroups--, in+=16*GHASH_VCLMUL_POWERS,
+                            out+=16*GHASH_VCLMUL_POWERS)
+  {
+    ghash_vclmul(htab, Y, in, GHASH_VCLMUL_POWERS);
+    aes128e_ctr32(kctxt, out, in, ctr, GHASH_VCLMUL_POWERS);
+  }
+}
+
+#endif
+
+//end of file
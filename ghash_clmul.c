@@ -0,0 +1,130 @@
+//-------------------------------------------------------------------
+// FILE: ghash_clmul.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  PCLMULQDQ implementation of GHASH following the Intel white paper
+//  "Intel Carry-Less Multiplication Instruction and its Usage for
+//  Computing the GCM Mode". H^1..H^8 are precomputed per key and 8
+//  blocks are folded per iteration,
+//    Y=(Y^X1)*H^8 ^ X2*H^7 ^ ... ^ X8*H
+//  with the 256-bit products summed unreduced and a single reduction
+//  per iteration. must be compiled with -mpclmul -msse4.1, it is only
+//  called when cpu_features() reports CPU_PCLMUL
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+
+#include "ghash_impl.h"
+#include "aes128gcm.h"
+
+#if defined(__PCLMUL__) && defined(__SSE4_1__)
+
+#include "ghash_clmul_inline.h"
+
+//-------------------------------------------------------------------
+void ghash_clmul_init(void *htab, const unsigned char *H)
+{
+  __m128i *hp=(__m128i *)htab;
+  __m128i h=bswap(_mm_loadu_si128((const __m128i *)H));
+  __m128i p=h;
+
+  //hp[i] holds H^(i+1), byte reversed
+  _mm_storeu_si128(hp, h);
+  for(int i=1; i<GHASH_CLMUL_POWERS; i++)
+  {
+    p=gf_mul(p, h);
+    _mm_storeu_si128(hp+i, p);
+  }
+}
+
+//-------------------------------------------------------------------
+void ghash_clmul(const void *htab, unsigned char *Y,
+                 const unsigned char *X, unsigned long nblocks)
+{
+  const __m128i *hp=(const __m128i *)htab;
+  __m128i y=bswap(_mm_loadu_si128((const __m128i *)Y));
+  __m128i hpow[GHASH_CLMUL_POWERS];
+
+  for(int i=0; i<GHASH_CLMUL_POWERS; i++)
+    hpow[i]=_mm_loadu_si128(hp+i);
+
+  for(; nblocks>=GHASH_CLMUL_POWERS; nblocks-=GHASH_CLMUL_POWERS,
+                                     X+=16*GHASH_CLMUL_POWERS)
+  {
+    __m128i lo=_mm_setzero_si128(), hi=_mm_setzero_si128();
+    __m128i x;
+
+    //the blocks not touched by Y first, only the last multiply and
+    //the reduction wait for the previous iteration
+    for(int j=1; j<GHASH_CLMUL_POWERS; j++)
+    {
+      x=bswap(_mm_loadu_si128((const __m128i *)(X+16*j)));
+      clmul_acc(x, hpow[GHASH_CLMUL_POWERS-1-j], &lo, &hi);
+    }
+    x=_mm_xor_si128(y, bswap(_mm_loadu_si128((const __m128i *)X)));
+    clmul_acc(x, hpow[GHASH_CLMUL_POWERS-1], &lo, &hi);
+    y=gf_reduce(lo, hi);
+  }
+  for(; nblocks; nblocks--, X+=16)
+    y=gf_mul(_mm_xor_si128(y, bswap(_mm_loadu_si128((const __m128i *)X))),
+             hpow[0]);
+
+  _mm_storeu_si128((__m128i *)Y, bswap(y));
+}
+
+//-------------------------------------------------------------------
+void ghash_clmul_init_lanes(void *const *htab,
+                            const unsigned char *const *H, unsigned int n)
+{
+  for(unsigned int i=0; i<n; i+=GHASH_LANES)
+  {
+    unsigned int m= (n-i < GHASH_LANES) ? n-i : GHASH_LANES;
+    __m128i h[GHASH_LANES], p[GHASH_LANES];
+
+    for(unsigned int l=0; l<m; l++)
+    {
+      h[l]=p[l]=bswap(_mm_loadu_si128((const __m128i *)H[i+l]));
+      _mm_storeu_si128((__m128i *)htab[i+l], h[l]);
+    }
+    for(int k=1; k<GHASH_CLMUL_POWERS; k++)
+      for(unsigned int l=0; l<m; l++)
+      {
+        p[l]=gf_mul(p[l], h[l]);
+        _mm_storeu_si128((__m128i *)htab[i+l]+k, p[l]);
+      }
+  }
+}
+
+#else
+
+//built without PCLMULQDQ support, cpu_features() never selects these.
+//they keep H in the table and use the bit serial multiply
+void ghash_clmul_init(void *htab, const unsigned char *H)
+{
+  for(int i=0; i<16; i++)
+    ((unsigned char *)htab)[i]=H[i];
+}
+
+void ghash_clmul_init_lanes(void *const *htab,
+                            const unsigned char *const *H, unsigned int n)
+{
+  for(unsigned int i=0; i<n; i++)
+    ghash_clmul_init(htab[i], H[i]);
+}
+
+void ghash_clmul(const void *htab, unsigned char *Y,
+                 const unsigned char *X, unsigned long nblocks)
+{
+  unsigned char x[16];
+
+  for(; nblocks; nblocks--, X+=16)
+  {
+    xor_128(Y, X, x);
+    gmul_128(x, (const unsigned char *)htab, Y);
+  }
+}
+
+#endif
+
+//end of file
@@ -0,0 +1,87 @@
+#ifndef GHASH_CLMUL_INLINE_H
+#define GHASH_CLMUL_INLINE_H
+
+//-------------------------------------------------------------------
+// FILE: ghash_clmul_inline.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  carry-less multiply helpers shared by the PCLMULQDQ GHASH and the
+//  stitched AES-NI/PCLMULQDQ GCM loop. only for files compiled with
+//  -mpclmul -msse4.1
+//-------------------------------------------------------------------
+
+#include <wmmintrin.h>
+#include <smmintrin.h>
+
+//-------------------------------------------------------------------
+//blocks are byte reversed so that the bit reflected GCM elements
+//can be multiplied as ordinary polynomials
+static inline __m128i bswap(__m128i x)
+{
+  const __m128i mask=_mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                  8, 9, 10, 11, 12, 13, 14, 15);
+  return _mm_shuffle_epi8(x, mask);
+}
+
+//-------------------------------------------------------------------
+//256-bit carry-less product a*b added to hi:lo
+static inline void clmul_acc(__m128i a, __m128i b, __m128i *lo, __m128i *hi)
+{
+  __m128i l=_mm_clmulepi64_si128(a, b, 0x00);
+  __m128i h=_mm_clmulepi64_si128(a, b, 0x11);
+  __m128i m=_mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10),
+                          _mm_clmulepi64_si128(a, b, 0x01));
+
+  *lo=_mm_xor_si128(*lo, _mm_xor_si128(l, _mm_slli_si128(m, 8)));
+  *hi=_mm_xor_si128(*hi, _mm_xor_si128(h, _mm_srli_si128(m, 8)));
+}
+
+//-------------------------------------------------------------------
+//reduces hi:lo modulo x^128+x^7+x^2+x+1 in the reflected domain.
+//the product of two reflected elements is one bit short, hence the
+//shift left by one first
+static inline __m128i gf_reduce(__m128i lo, __m128i hi)
+{
+  __m128i t7, t8, t9, t2, t4, t5;
+
+  t7=_mm_srli_epi32(lo, 31);
+  t8=_mm_srli_epi32(hi, 31);
+  lo=_mm_slli_epi32(lo, 1);
+  hi=_mm_slli_epi32(hi, 1);
+  t9=_mm_srli_si128(t7, 12);
+  t8=_mm_slli_si128(t8, 4);
+  t7=_mm_slli_si128(t7, 4);
+  lo=_mm_or_si128(lo, t7);
+  hi=_mm_or_si128(hi, t8);
+  hi=_mm_or_si128(hi, t9);
+
+  t7=_mm_slli_epi32(lo, 31);
+  t8=_mm_slli_epi32(lo, 30);
+  t9=_mm_slli_epi32(lo, 25);
+  t7=_mm_xor_si128(t7, t8);
+  t7=_mm_xor_si128(t7, t9);
+  t8=_mm_srli_si128(t7, 4);
+  t7=_mm_slli_si128(t7, 12);
+  lo=_mm_xor_si128(lo, t7);
+
+  t2=_mm_srli_epi32(lo, 1);
+  t4=_mm_srli_epi32(lo, 2);
+  t5=_mm_srli_epi32(lo, 7);
+  t2=_mm_xor_si128(t2, t4);
+  t2=_mm_xor_si128(t2, t5);
+  t2=_mm_xor_si128(t2, t8);
+  lo=_mm_xor_si128(lo, t2);
+  return _mm_xor_si128(hi, lo);
+}
+
+//-------------------------------------------------------------------
+static inline __m128i gf_mul(__m128i a, __m128i b)
+{
+  __m128i lo=_mm_setzero_si128(), hi=_mm_setzero_si128();
+
+  clmul_acc(a, b, &lo, &hi);
+  return gf_reduce(lo, hi);
+}
+
+#endif
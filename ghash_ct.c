@@ -0,0 +1,190 @@
+//-------------------------------------------------------------------
+// FILE: ghash_ct.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  constant time portable GHASH without lookup tables. a carry-less
+//  64x64 multiply is done with ordinary integer multiplies of the
+//  operands masked to every 4th bit, so the carries of the sums land
+//  in the bits masked off afterwards (BearSSL's ctmul64). a 128-bit
+//  product takes three of them by Karatsuba, three more on the bit
+//  reversed operands give the high halves. products of
+//  GHASH_CT_POWERS blocks with H^n..H^1 are summed unreduced and
+//  reduced once. no branch or memory index depends on H or the data.
+//  field elements are held as two 64-bit halves, hi being the first
+//  8 bytes of the block
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+
+#include "ghash_impl.h"
+
+//words kept per power of H: both halves, their XOR and the bit
+//reversals of the three
+enum
+{
+  HW_LO=0, HW_HI, HW_MID, HW_LOR, HW_HIR, HW_MIDR, HW_WORDS
+};
+
+//-------------------------------------------------------------------
+static inline uint64_t load64(const unsigned char *p)
+{
+  uint64_t v=0;
+  for(int i=0; i<8; i++)
+    v=(v << 8) | p[i];
+  return v;
+}
+
+//-------------------------------------------------------------------
+static inline void store64(unsigned char *p, uint64_t v)
+{
+  for(int i=7; i>=0; i--, v>>=8)
+    p[i]=(unsigned char)v;
+}
+
+//-------------------------------------------------------------------
+//low 64 bits of the carry-less product x*y
+static inline uint64_t bmul64(uint64_t x, uint64_t y)
+{
+  const uint64_t m0=0x1111111111111111ULL, m1=0x2222222222222222ULL,
+                 m2=0x4444444444444444ULL, m3=0x8888888888888888ULL;
+  uint64_t x0=x & m0, x1=x & m1, x2=x & m2, x3=x & m3;
+  uint64_t y0=y & m0, y1=y & m1, y2=y & m2, y3=y & m3;
+  uint64_t z0, z1, z2, z3;
+
+  z0=(x0*y0) ^ (x1*y3) ^ (x2*y2) ^ (x3*y1);
+  z1=(x0*y1) ^ (x1*y0) ^ (x2*y3) ^ (x3*y2);
+  z2=(x0*y2) ^ (x1*y1) ^ (x2*y0) ^ (x3*y3);
+  z3=(x0*y3) ^ (x1*y2) ^ (x2*y1) ^ (x3*y0);
+  return (z0 & m0) | (z1 & m1) | (z2 & m2) | (z3 & m3);
+}
+
+//-------------------------------------------------------------------
+static inline uint64_t rev64(uint64_t x)
+{
+  x=((x & 0x5555555555555555ULL) << 1) | ((x >> 1) & 0x5555555555555555ULL);
+  x=((x & 0x3333333333333333ULL) << 2) | ((x >> 2) & 0x3333333333333333ULL);
+  x=((x & 0x0F0F0F0F0F0F0F0FULL) << 4) | ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL);
+  x=((x & 0x00FF00FF00FF00FFULL) << 8) | ((x >> 8) & 0x00FF00FF00FF00FFULL);
+  x=((x & 0x0000FFFF0000FFFFULL) << 16) | ((x >> 16) & 0x0000FFFF0000FFFFULL);
+  return (x << 32) | (x >> 32);
+}
+
+//-------------------------------------------------------------------
+//v[0..3]^=unreduced product of (hi,lo) and the power h, in the bit
+//reflected order of GHASH shifted left by one
+static inline void mul_acc(uint64_t *v, uint64_t hi, uint64_t lo,
+                           const uint64_t *h)
+{
+  uint64_t lor=rev64(lo), hir=rev64(hi);
+  uint64_t z0, z1, z2, z0h, z1h, z2h;
+
+  z0=bmul64(lo, h[HW_LO]);
+  z1=bmul64(hi, h[HW_HI]);
+  z2=bmul64(lo ^ hi, h[HW_MID]);
+  z0h=bmul64(lor, h[HW_LOR]);
+  z1h=bmul64(hir, h[HW_HIR]);
+  z2h=bmul64(lor ^ hir, h[HW_MIDR]);
+  z2^=z0 ^ z1;
+  z2h^=z0h ^ z1h;
+  z0h=rev64(z0h) >> 1;
+  z1h=rev64(z1h) >> 1;
+  z2h=rev64(z2h) >> 1;
+
+  v[0]^=z0;
+  v[1]^=z0h ^ z2;
+  v[2]^=z1 ^ z2h;
+  v[3]^=z1h;
+}
+
+//-------------------------------------------------------------------
+//reduces v[0..3] modulo the GHASH polynomial into (*hi,*lo)
+static inline void reduce(const uint64_t *v, uint64_t *hi, uint64_t *lo)
+{
+  uint64_t v0=v[0], v1=v[1], v2=v[2], v3=v[3];
+
+  v3=(v3 << 1) | (v2 >> 63);
+  v2=(v2 << 1) | (v1 >> 63);
+  v1=(v1 << 1) | (v0 >> 63);
+  v0<<=1;
+
+  v2^=v0 ^ (v0 >> 1) ^ (v0 >> 2) ^ (v0 >> 7);
+  v1^=(v0 << 63) ^ (v0 << 62) ^ (v0 << 57);
+  v3^=v1 ^ (v1 >> 1) ^ (v1 >> 2) ^ (v1 >> 7);
+  v2^=(v1 << 63) ^ (v1 << 62) ^ (v1 << 57);
+  *lo=v2;
+  *hi=v3;
+}
+
+//-------------------------------------------------------------------
+static void set_power(uint64_t *h, uint64_t hi, uint64_t lo)
+{
+  h[HW_LO]=lo;
+  h[HW_HI]=hi;
+  h[HW_MID]=lo ^ hi;
+  h[HW_LOR]=rev64(lo);
+  h[HW_HIR]=rev64(hi);
+  h[HW_MIDR]=h[HW_LOR] ^ h[HW_HIR];
+}
+
+//-------------------------------------------------------------------
+void ghash_ct_init(void *htab, const unsigned char *H)
+{
+  uint64_t *h=(uint64_t *)htab;
+  uint64_t v[4], hi=load64(H), lo=load64(&H[8]);
+
+  //h[n-1] holds H^n
+  set_power(h, hi, lo);
+  for(int n=1; n<GHASH_CT_POWERS; n++)
+  {
+    v[0]=v[1]=v[2]=v[3]=0;
+    mul_acc(v, hi, lo, h);
+    reduce(v, &hi, &lo);
+    set_power(&h[HW_WORDS*n], hi, lo);
+  }
+}
+
+//-------------------------------------------------------------------
+void ghash_ct(const void *htab, unsigned char *Y,
+              const unsigned char *X, unsigned long nblocks)
+{
+  const uint64_t *h=(const uint64_t *)htab;
+  uint64_t v[4], yhi=load64(Y), ylo=load64(&Y[8]);
+
+  //Y=(Y^X[0])*H^n ^ X[1]*H^(n-1) ^ ... ^ X[n-1]*H
+  for(; nblocks>=GHASH_CT_POWERS; nblocks-=GHASH_CT_POWERS)
+  {
+    v[0]=v[1]=v[2]=v[3]=0;
+    mul_acc(v, yhi ^ load64(X), ylo ^ load64(&X[8]),
+            &h[HW_WORDS*(GHASH_CT_POWERS-1)]);
+    for(int i=1; i<GHASH_CT_POWERS; i++)
+      mul_acc(v, load64(&X[16*i]), load64(&X[16*i+8]),
+              &h[HW_WORDS*(GHASH_CT_POWERS-1-i)]);
+    reduce(v, &yhi, &ylo);
+    X+=16*GHASH_CT_POWERS;
+  }
+  for(; nblocks; nblocks--, X+=16)
+  {
+    v[0]=v[1]=v[2]=v[3]=0;
+    mul_acc(v, yhi ^ load64(X), ylo ^ load64(&X[8]), h);
+    reduce(v, &yhi, &ylo);
+  }
+
+  store64(Y, yhi);
+  store64(&Y[8], ylo);
+}
+
+//-------------------------------------------------------------------
+void ghash_ct_mul(unsigned char *out, const unsigned char *X,
+                  const unsigned char *Y)
+{
+  uint64_t h[HW_WORDS], v[4]={0, 0, 0, 0}, hi, lo;
+
+  set_power(h, load64(Y), load64(&Y[8]));
+  mul_acc(v, load64(X), load64(&X[8]), h);
+  reduce(v, &hi, &lo);
+  store64(out, hi);
+  store64(&out[8], lo);
+}
+
+//end of file
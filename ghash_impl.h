@@ -0,0 +1,140 @@
+#ifndef GHASH_IMPL_H
+#define GHASH_IMPL_H
+
+//-------------------------------------------------------------------
+// FILE: ghash_impl.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// MODIFIED: 17-oct-2026 //VPCLMULQDQ GHASH and VAES stitched loop
+// DESCRIPTION:
+//  internal header with the GHASH backends behind gcm_ghash(). each
+//  backend has an init function filling its per key table from H
+//  and an update function computing Y=(Y^X[i])*H over nblocks
+//  blocks. all of them give identical results
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+
+#include "aes128e.h"
+
+//size in bytes of the per key tables
+#define GHASH_TAB4_SIZE (16*16)
+#define GHASH_TAB8_SIZE (256*16)
+//powers of H kept by the carry-less multiply backend
+#define GHASH_CLMUL_POWERS 8
+#define GHASH_CLMUL_SIZE (GHASH_CLMUL_POWERS*16)
+//the AVX-512 backend keeps the GHASH_CLMUL table followed by
+//H^16..H^1
+#define GHASH_VCLMUL_POWERS 16
+#define GHASH_VCLMUL_SIZE (GHASH_CLMUL_SIZE+GHASH_VCLMUL_POWERS*16)
+//powers of H kept by the constant time backend, six 64-bit words
+//each
+#define GHASH_CT_POWERS 4
+#define GHASH_CT_SIZE (GHASH_CT_POWERS*6*8)
+//keys whose H powers ghash_clmul_init_lanes() computes side by side
+#define GHASH_LANES 8
+
+void ghash_tab4_init(void *htab, const unsigned char *H);
+void ghash_tab4(const void *htab, unsigned char *Y,
+                const unsigned char *X, unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  Shoup's 4-bit method, table of the 16 multiples n*H of a nibble
+//-------------------------------------------------------------------
+
+void ghash_tab8_init(void *htab, const unsigned char *H);
+void ghash_tab8(const void *htab, unsigned char *Y,
+                const unsigned char *X, unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  8-bit method, table of the 256 multiples n*H of a byte
+//-------------------------------------------------------------------
+
+void ghash_ct_init(void *htab, const unsigned char *H);
+void ghash_ct(const void *htab, unsigned char *Y,
+              const unsigned char *X, unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  portable constant time multiply from masked integer multiplies,
+//  Karatsuba halves and one reduction per GHASH_CT_POWERS blocks.
+//  the table holds H^1..H^4 only, it is never indexed by data
+//-------------------------------------------------------------------
+
+void ghash_ct_mul(unsigned char *out, const unsigned char *X,
+                  const unsigned char *Y);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  out=X*Y in constant time with the same multiply, no table. out
+//  may alias X or Y
+//-------------------------------------------------------------------
+
+void ghash_clmul_init(void *htab, const unsigned char *H);
+void ghash_clmul(const void *htab, unsigned char *Y,
+                 const unsigned char *X, unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  PCLMULQDQ multiply, table of H^1..H^8 and one reduction per 8
+//  blocks
+//-------------------------------------------------------------------
+
+void ghash_vclmul_init(void *htab, const unsigned char *H);
+void ghash_vclmul(const void *htab, unsigned char *Y,
+                  const unsigned char *X, unsigned long nblocks);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  VPCLMULQDQ multiply of 4 blocks per instruction, one reduction per
+//  16 blocks. shorter inputs go through ghash_clmul()
+//-------------------------------------------------------------------
+
+void ghash_clmul_init_lanes(void *const *htab,
+                            const unsigned char *const *H, unsigned int n);
+void ghash_vclmul_init_lanes(void *const *htab,
+                             const unsigned char *const *H, unsigned int n);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  the init functions for n keys, the H power chains of GHASH_LANES
+//  keys advance side by side
+//-------------------------------------------------------------------
+
+void gcm_stitch_aesni(const key_ctxt *kctxt, const void *htab,
+                      unsigned char *out, const unsigned char *in,
+                      unsigned char *ctr, unsigned char *Y,
+                      unsigned long ngroups);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  stitched AES-NI counter mode and PCLMULQDQ GHASH over ngroups
+//  groups of GHASH_CLMUL_POWERS blocks. htab is the GHASH_CLMUL
+//  table, ctr and Y are updated as by aes128e_ctr32() and gcm_ghash()
+//-------------------------------------------------------------------
+
+void gcm_stitch_aesni_dec(const key_ctxt *kctxt, const void *htab,
+                          unsigned char *out, const unsigned char *in,
+                          unsigned char *ctr, unsigned char *Y,
+                          unsigned long ngroups);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  decrypting counterpart, every group of ciphertext is hashed while
+//  its own counter blocks are encrypted
+//-------------------------------------------------------------------
+
+void gcm_stitch_vaes(const key_ctxt *kctxt, const void *htab,
+                     unsigned char *out, const unsigned char *in,
+                     unsigned char *ctr, unsigned char *Y,
+                     unsigned long ngroups);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  stitched VAES counter mode and VPCLMULQDQ GHASH over ngroups
+//  groups of GHASH_VCLMUL_POWERS blocks. htab is the GHASH_VCLMUL
+//  table
+//-------------------------------------------------------------------
+
+void gcm_stitch_vaes_dec(const key_ctxt *kctxt, const void *htab,
+                         unsigned char *out, const unsigned char *in,
+                         unsigned char *ctr, unsigned char *Y,
+                         unsigned long ngroups);
+//-------------------------------------------------------------------
+// DESCRIPTION:
+//  decrypting counterpart of gcm_stitch_vaes()
+//-------------------------------------------------------------------
+
+#endif
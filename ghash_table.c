@@ -0,0 +1,198 @@
+//-------------------------------------------------------------------
+// FILE: ghash_table.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  table driven GHASH (Shoup's method). the multiples of H for every
+//  nibble or byte value are precomputed once per key, a block is
+//  then multiplied by H with one table lookup per nibble/byte and a
+//  shift by 4/8 bits whose carry out is reduced with a small constant
+//  table. field elements are held as two 64-bit halves, hi being the
+//  first 8 bytes of the block
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+
+#include "ghash_impl.h"
+
+typedef struct
+{
+  uint64_t hi, lo;
+}fe128;
+
+//reduction of the 4 bits shifted out of the low end, to be XORed
+//into the top 16 bits
+static const uint16_t rem_4bit[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0 };
+
+//same for the 8 bits shifted out by the byte wise method
+static const uint16_t rem_8bit[256] = {
+    0x0000, 0x01c2, 0x0384, 0x0246, 0x0708, 0x06ca, 0x048c, 0x054e,
+    0x0e10, 0x0fd2, 0x0d94, 0x0c56, 0x0918, 0x08da, 0x0a9c, 0x0b5e,
+    0x1c20, 0x1de2, 0x1fa4, 0x1e66, 0x1b28, 0x1aea, 0x18ac, 0x196e,
+    0x1230, 0x13f2, 0x11b4, 0x1076, 0x1538, 0x14fa, 0x16bc, 0x177e,
+    0x3840, 0x3982, 0x3bc4, 0x3a06, 0x3f48, 0x3e8a, 0x3ccc, 0x3d0e,
+    0x3650, 0x3792, 0x35d4, 0x3416, 0x3158, 0x309a, 0x32dc, 0x331e,
+    0x2460, 0x25a2, 0x27e4, 0x2626, 0x2368, 0x22aa, 0x20ec, 0x212e,
+    0x2a70, 0x2bb2, 0x29f4, 0x2836, 0x2d78, 0x2cba, 0x2efc, 0x2f3e,
+    0x7080, 0x7142, 0x7304, 0x72c6, 0x7788, 0x764a, 0x740c, 0x75ce,
+    0x7e90, 0x7f52, 0x7d14, 0x7cd6, 0x7998, 0x785a, 0x7a1c, 0x7bde,
+    0x6ca0, 0x6d62, 0x6f24, 0x6ee6, 0x6ba8, 0x6a6a, 0x682c, 0x69ee,
+    0x62b0, 0x6372, 0x6134, 0x60f6, 0x65b8, 0x647a, 0x663c, 0x67fe,
+    0x48c0, 0x4902, 0x4b44, 0x4a86, 0x4fc8, 0x4e0a, 0x4c4c, 0x4d8e,
+    0x46d0, 0x4712, 0x4554, 0x4496, 0x41d8, 0x401a, 0x425c, 0x439e,
+    0x54e0, 0x5522, 0x5764, 0x56a6, 0x53e8, 0x522a, 0x506c, 0x51ae,
+    0x5af0, 0x5b32, 0x5974, 0x58b6, 0x5df8, 0x5c3a, 0x5e7c, 0x5fbe,
+    0xe100, 0xe0c2, 0xe284, 0xe346, 0xe608, 0xe7ca, 0xe58c, 0xe44e,
+    0xef10, 0xeed2, 0xec94, 0xed56, 0xe818, 0xe9da, 0xeb9c, 0xea5e,
+    0xfd20, 0xfce2, 0xfea4, 0xff66, 0xfa28, 0xfbea, 0xf9ac, 0xf86e,
+    0xf330, 0xf2f2, 0xf0b4, 0xf176, 0xf438, 0xf5fa, 0xf7bc, 0xf67e,
+    0xd940, 0xd882, 0xdac4, 0xdb06, 0xde48, 0xdf8a, 0xddcc, 0xdc0e,
+    0xd750, 0xd692, 0xd4d4, 0xd516, 0xd058, 0xd19a, 0xd3dc, 0xd21e,
+    0xc560, 0xc4a2, 0xc6e4, 0xc726, 0xc268, 0xc3aa, 0xc1ec, 0xc02e,
+    0xcb70, 0xcab2, 0xc8f4, 0xc936, 0xcc78, 0xcdba, 0xcffc, 0xce3e,
+    0x9180, 0x9042, 0x9204, 0x93c6, 0x9688, 0x974a, 0x950c, 0x94ce,
+    0x9f90, 0x9e52, 0x9c14, 0x9dd6, 0x9898, 0x995a, 0x9b1c, 0x9ade,
+    0x8da0, 0x8c62, 0x8e24, 0x8fe6, 0x8aa8, 0x8b6a, 0x892c, 0x88ee,
+    0x83b0, 0x8272, 0x8034, 0x81f6, 0x84b8, 0x857a, 0x873c, 0x86fe,
+    0xa9c0, 0xa802, 0xaa44, 0xab86, 0xaec8, 0xaf0a, 0xad4c, 0xac8e,
+    0xa7d0, 0xa612, 0xa454, 0xa596, 0xa0d8, 0xa11a, 0xa35c, 0xa29e,
+    0xb5e0, 0xb422, 0xb664, 0xb7a6, 0xb2e8, 0xb32a, 0xb16c, 0xb0ae,
+    0xbbf0, 0xba32, 0xb874, 0xb9b6, 0xbcf8, 0xbd3a, 0xbf7c, 0xbebe };
+
+//-------------------------------------------------------------------
+static inline uint64_t load64(const unsigned char *p)
+{
+  uint64_t v=0;
+  for(int i=0; i<8; i++)
+    v=(v << 8) | p[i];
+  return v;
+}
+
+//-------------------------------------------------------------------
+static inline void store64(unsigned char *p, uint64_t v)
+{
+  for(int i=7; i>=0; i--, v>>=8)
+    p[i]=(unsigned char)v;
+}
+
+//-------------------------------------------------------------------
+//multiplication by x, a right shift in the GCM bit order
+static inline fe128 mulx(fe128 v)
+{
+  uint64_t r= (v.lo & 1) ? (uint64_t)0xe1 << 56 : 0;
+  v.lo=(v.lo >> 1) | (v.hi << 63);
+  v.hi=(v.hi >> 1) ^ r;
+  return v;
+}
+
+//-------------------------------------------------------------------
+//fills tab[0..2^bits-1] with n*H, the most significant index bit is
+//the coefficient of x^0
+static void build_table(fe128 *tab, int bits, const unsigned char *H)
+{
+  int n=1 << bits;
+  fe128 v;
+
+  v.hi=load64(H);
+  v.lo=load64(H+8);
+  tab[0].hi=tab[0].lo=0;
+  for(int i=n/2; i>0; i>>=1)
+  {
+    tab[i]=v;
+    v=mulx(v);
+  }
+  for(int i=2; i<n; i<<=1)
+    for(int j=1; j<i; j++)
+    {
+      tab[i+j].hi=tab[i].hi ^ tab[j].hi;
+      tab[i+j].lo=tab[i].lo ^ tab[j].lo;
+    }
+}
+
+//-------------------------------------------------------------------
+void ghash_tab4_init(void *htab, const unsigned char *H)
+{
+  build_table((fe128 *)htab, 4, H);
+}
+
+//-------------------------------------------------------------------
+void ghash_tab8_init(void *htab, const unsigned char *H)
+{
+  build_table((fe128 *)htab, 8, H);
+}
+
+//-------------------------------------------------------------------
+void ghash_tab4(const void *htab, unsigned char *Y,
+                const unsigned char *X, unsigned long nblocks)
+{
+  const fe128 *tab=(const fe128 *)htab;
+  unsigned char x[16];
+  uint64_t zhi, zlo, rem;
+
+  for(int i=0; i<16; i++)
+    x[i]=Y[i];
+  for(; nblocks; nblocks--, X+=16)
+  {
+    for(int i=0; i<16; i++)
+      x[i]^=X[i];
+
+    //horner's rule from the highest degree nibble down
+    zhi=tab[x[15] & 0xf].hi;
+    zlo=tab[x[15] & 0xf].lo;
+    for(int i=15; ; )
+    {
+      rem=zlo & 0xf;
+      zlo=(zlo >> 4) | (zhi << 60);
+      zhi=(zhi >> 4) ^ ((uint64_t)rem_4bit[rem] << 48);
+      zhi^=tab[x[i] >> 4].hi;
+      zlo^=tab[x[i] >> 4].lo;
+      if(--i<0)
+        break;
+      rem=zlo & 0xf;
+      zlo=(zlo >> 4) | (zhi << 60);
+      zhi=(zhi >> 4) ^ ((uint64_t)rem_4bit[rem] << 48);
+      zhi^=tab[x[i] & 0xf].hi;
+      zlo^=tab[x[i] & 0xf].lo;
+    }
+    store64(x, zhi);
+    store64(x+8, zlo);
+  }
+  for(int i=0; i<16; i++)
+    Y[i]=x[i];
+}
+
+//-------------------------------------------------------------------
+void ghash_tab8(const void *htab, unsigned char *Y,
+                const unsigned char *X, unsigned long nblocks)
+{
+  const fe128 *tab=(const fe128 *)htab;
+  unsigned char x[16];
+  uint64_t zhi, zlo, rem;
+
+  for(int i=0; i<16; i++)
+    x[i]=Y[i];
+  for(; nblocks; nblocks--, X+=16)
+  {
+    for(int i=0; i<16; i++)
+      x[i]^=X[i];
+
+    zhi=tab[x[15]].hi;
+    zlo=tab[x[15]].lo;
+    for(int i=14; i>=0; i--)
+    {
+      rem=zlo & 0xff;
+      zlo=(zlo >> 8) | (zhi << 56);
+      zhi=(zhi >> 8) ^ ((uint64_t)rem_8bit[rem] << 48);
+      zhi^=tab[x[i]].hi;
+      zlo^=tab[x[i]].lo;
+    }
+    store64(x, zhi);
+    store64(x+8, zlo);
+  }
+  for(int i=0; i<16; i++)
+    Y[i]=x[i];
+}
+
+//end of file
@@ -0,0 +1,132 @@
+//-------------------------------------------------------------------
+// FILE: ghash_vclmul.c
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  AVX-512 VPCLMULQDQ implementation of GHASH. 16 blocks are folded
+//  per iteration,
+//    Y=(Y^X1)*H^16 ^ X2*H^15 ^ ... ^ X16*H
+//  4 blocks per multiply and a single reduction per iteration. the
+//  table starts with the GHASH_CLMUL table, so the PCLMULQDQ code
+//  handles the tail and the multi lane hash with the same table. must
+//  be compiled with the VAES_FLAGS of the Makefile, it is only called
+//  when cpu_features() reports CPU_VAES512
+//-------------------------------------------------------------------
+
+#include <stdint.h>
+
+#include "ghash_impl.h"
+#include "aes128gcm.h"
+
+#if defined(__VPCLMULQDQ__) && defined(__AVX512F__) && \
+    defined(__AVX512BW__) && defined(__PCLMUL__)
+
+#include "ghash_vclmul_inline.h"
+
+//-------------------------------------------------------------------
+void ghash_vclmul_init(void *htab, const unsigned char *H)
+{
+  __m128i *hp=(__m128i *)htab;
+  __m128i *hz=hp+GHASH_CLMUL_POWERS;
+  __m128i h, p;
+
+  ghash_clmul_init(htab, H);
+  //hz[j] holds H^(16-j), byte reversed, so that a 64-byte load gives
+  //the powers of 4 consecutive blocks
+  h=_mm_loadu_si128(hp);
+  p=h;
+  for(int i=1; i<=GHASH_VCLMUL_POWERS; i++)
+  {
+    _mm_storeu_si128(hz+GHASH_VCLMUL_POWERS-i, p);
+    p=gf_mul(p, h);
+  }
+}
+
+//-------------------------------------------------------------------
+void ghash_vclmul_init_lanes(void *const *htab,
+                             const unsigned char *const *H, unsigned int n)
+{
+  for(unsigned int i=0; i<n; i+=GHASH_LANES)
+  {
+    unsigned int m= (n-i < GHASH_LANES) ? n-i : GHASH_LANES;
+    __m128i h[GHASH_LANES], p[GHASH_LANES];
+
+    for(unsigned int l=0; l<m; l++)
+      h[l]=p[l]=bswap(_mm_loadu_si128((const __m128i *)H[i+l]));
+    //H^k goes to the CLMUL table for k<=8 and to hz[16-k]
+    for(int k=1; k<=GHASH_VCLMUL_POWERS; k++)
+      for(unsigned int l=0; l<m; l++)
+      {
+        __m128i *hp=(__m128i *)htab[i+l];
+
+        if(k>1)
+          p[l]=gf_mul(p[l], h[l]);
+        if(k<=GHASH_CLMUL_POWERS)
+          _mm_storeu_si128(hp+k-1, p[l]);
+        _mm_storeu_si128(hp+GHASH_CLMUL_POWERS+GHASH_VCLMUL_POWERS-k, p[l]);
+      }
+  }
+}
+
+//-------------------------------------------------------------------
+void ghash_vclmul(const void *htab, unsigned char *Y,
+                  const unsigned char *X, unsigned long nblocks)
+{
+  const __m128i *hz=(const __m128i *)htab+GHASH_CLMUL_POWERS;
+
+  if(nblocks>=GHASH_VCLMUL_POWERS)
+  {
+    __m128i y=bswap(_mm_loadu_si128((const __m128i *)Y));
+    __m512i hpow[GHASH_VCLMUL_POWERS/4];
+
+    for(int j=0; j<GHASH_VCLMUL_POWERS/4; j++)
+      hpow[j]=_mm512_loadu_si512(hz+4*j);
+
+    for(; nblocks>=GHASH_VCLMUL_POWERS; nblocks-=GHASH_VCLMUL_POWERS,
+                                        X+=16*GHASH_VCLMUL_POWERS)
+    {
+      __m512i lo=_mm512_setzero_si512(), mid=_mm512_setzero_si512();
+      __m512i hi=_mm512_setzero_si512();
+      __m512i x;
+
+      //the blocks not touched by Y first, so that only the last
+      //multiply and the reduction wait for the previous iteration
+      for(int j=1; j<GHASH_VCLMUL_POWERS/4; j++)
+      {
+        x=bswap512(_mm512_loadu_si512(X+64*j));
+        clmul512_acc(x, hpow[j], &lo, &mid, &hi);
+      }
+      x=_mm512_xor_si512(bswap512(_mm512_loadu_si512(X)),
+                         _mm512_zextsi128_si512(y));
+      clmul512_acc(x, hpow[0], &lo, &mid, &hi);
+      y=gf_reduce512(lo, mid, hi);
+    }
+    _mm_storeu_si128((__m128i *)Y, bswap(y));
+  }
+  ghash_clmul(htab, Y, X, nblocks);
+}
+
+#else
+
+//built without VPCLMULQDQ support, cpu_features() never selects
+//these
+void ghash_vclmul_init(void *htab, const unsigned char *H)
+{
+  ghash_clmul_init(htab, H);
+}
+
+void ghash_vclmul_init_lanes(void *const *htab,
+                             const unsigned char *const *H, unsigned int n)
+{
+  ghash_clmul_init_lanes(htab, H, n);
+}
+
+void ghash_vclmul(const void *htab, unsigned char *Y,
+                  const unsigned char *X, unsigned long nblocks)
+{
+  ghash_clmul(htab, Y, X, nblocks);
+}
+
+#endif
+
+//end of file
@@ -0,0 +1,61 @@
+#ifndef GHASH_VCLMUL_INLINE_H
+#define GHASH_VCLMUL_INLINE_H
+
+//-------------------------------------------------------------------
+// FILE: ghash_vclmul_inline.h
+// AUTHOR: Suhas Thejaswi
+// DATE: 17-oct-2026
+// DESCRIPTION:
+//  VPCLMULQDQ helpers shared by the AVX-512 GHASH and the stitched
+//  VAES/VPCLMULQDQ GCM loop. products of 4 blocks are accumulated
+//  per lane and folded to one 256-bit sum before the reduction. only
+//  for files compiled with the VAES_FLAGS of the Makefile
+//-------------------------------------------------------------------
+
+#include <immintrin.h>
+
+#include "ghash_clmul_inline.h"
+
+//-------------------------------------------------------------------
+static inline __m512i bswap512(__m512i x)
+{
+  const __m512i mask=_mm512_broadcast_i32x4(
+                       _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                    8, 9, 10, 11, 12, 13, 14, 15));
+  return _mm512_shuffle_epi8(x, mask);
+}
+
+//-------------------------------------------------------------------
+//lane wise 256-bit carry-less products a*b added to lo, mid and hi.
+//the middle terms are kept apart and folded once by gf_reduce512()
+static inline void clmul512_acc(__m512i a, __m512i b, __m512i *lo,
+                                __m512i *mid, __m512i *hi)
+{
+  *lo=_mm512_xor_si512(*lo, _mm512_clmulepi64_epi128(a, b, 0x00));
+  *hi=_mm512_xor_si512(*hi, _mm512_clmulepi64_epi128(a, b, 0x11));
+  //three way XOR
+  *mid=_mm512_ternarylogic_epi64(*mid,
+                                 _mm512_clmulepi64_epi128(a, b, 0x10),
+                                 _mm512_clmulepi64_epi128(a, b, 0x01),
+                                 0x96);
+}
+
+//-------------------------------------------------------------------
+//sums the 4 lanes and reduces the result
+static inline __m128i gf_reduce512(__m512i lo, __m512i mid, __m512i hi)
+{
+  __m256i l, h;
+
+  lo=_mm512_xor_si512(lo, _mm512_bslli_epi128(mid, 8));
+  hi=_mm512_xor_si512(hi, _mm512_bsrli_epi128(mid, 8));
+  l=_mm256_xor_si256(_mm512_castsi512_si256(lo),
+                     _mm512_extracti64x4_epi64(lo, 1));
+  h=_mm256_xor_si256(_mm512_castsi512_si256(hi),
+                     _mm512_extracti64x4_epi64(hi, 1));
+  return gf_reduce(_mm_xor_si128(_mm256_castsi256_si128(l),
+                                 _mm256_extracti128_si256(l, 1)),
+                   _mm_xor_si128(_mm256_castsi256_si128(h),
+                                 _mm256_extracti128_si256(h, 1)));
+}
+
+#endif